@@ -26,3 +26,76 @@ function(test_handling)
   list(APPEND CMAKE_CTEST_ARGUMENTS "--output-on-failure" "--progress")
 
 endfunction()
+
+# A test of how hard the solvers work on every puzzle in inputs/,
+# checked against counts kept in baseline_file
+#
+# Counts need the search statistics, so there is nothing to register
+# without them. The tests are labelled "effort", to run them alone with
+# ctest -L effort.
+function(register_effort_test input_test_file test_name baseline_file)
+
+  if(NOT SEARCH_STATS)
+    return()
+  endif()
+
+  register_test(${input_test_file} ${test_name})
+
+  target_compile_definitions(
+    ${test_name} PRIVATE SUDOKU_INPUTS_DIR="${TOP_DIR}/inputs"
+                         SEARCH_EFFORT_BASELINES="${baseline_file}")
+
+  set_tests_properties(${test_name} PROPERTIES LABELS effort)
+
+endfunction()
+
+# The whole-board kernels in checking.cpp are only compiled for a target
+# with SSE4.1 or AVX2, which the default build does not assume. This
+# builds the test again with its own copy of checking.cpp for each of
+# them, as test_name_sse41 and test_name_avx2, so the kernels are tested
+# against the scalar code without -DNATIVE_ARCH=YES.
+#
+# An instruction set is left out if the compiler does not know it, or if
+# this machine cannot run it. With -DNATIVE_ARCH=YES, the test itself
+# already uses the best kernel available.
+function(register_kernel_test input_test_file test_name)
+
+  if(NATIVE_ARCH)
+    return()
+  endif()
+
+  include(CheckCXXSourceRuns)
+
+  foreach(isa IN ITEMS sse4.1 avx2)
+    string(REPLACE "." "" suffix ${isa})
+
+    set(CMAKE_REQUIRED_FLAGS -m${isa})
+    set(CMAKE_REQUIRED_QUIET YES)
+    check_cxx_source_runs(
+      "int main() { return __builtin_cpu_supports(\"${isa}\") ? 0 : 1; }"
+      SUDOKU_CAN_RUN_${suffix})
+
+    if(NOT SUDOKU_CAN_RUN_${suffix})
+      continue()
+    endif()
+
+    set(variant ${test_name}_${suffix})
+
+    add_executable(${variant} ${input_test_file}
+                              ${TOP_DIR}/cpp/src/Sudoku/checking.cpp)
+
+    target_link_libraries(${variant} PRIVATE common_properties
+                                             supple::testing)
+
+    target_compile_options(${variant} PRIVATE -m${isa})
+
+    set_target_properties(${variant} PROPERTIES RUNTIME_OUTPUT_DIRECTORY
+                                                ${CMAKE_BINARY_DIR}/tests)
+
+    add_test(
+      NAME ${variant}
+      COMMAND ${variant}
+      WORKING_DIRECTORY ${CMAKE_BINARY_DIR}/tests)
+  endforeach()
+
+endfunction()
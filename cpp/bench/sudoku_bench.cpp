@@ -0,0 +1,545 @@
+// Microbenchmarks of the board and solver, on every puzzle in inputs/
+//
+// Each benchmark is run in batches of calls, the batch size doubled until
+// a batch takes at least the minimum sample time, so that the clock's
+// resolution and overhead vanish into it. After some warmup batches,
+// each timed batch gives one sample of the time per operation,
+// summarized by its median and median absolute deviation,
+// which unlike the mean and standard deviation are not dragged around
+// by the occasional batch interrupted by the rest of the system.
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "board_parser.hpp"
+#include "run_record.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+namespace {
+struct bench_options {
+  std::filesystem::path inputs {SUDOKU_INPUTS_DIR};
+
+  // where to write JSON, "-" for stdout
+  std::optional<std::string> json_path {};
+
+  std::size_t warmup {3};
+  std::size_t repetitions {15};
+  std::chrono::nanoseconds min_sample_time {std::chrono::milliseconds {2}};
+};
+
+struct bench_result {
+  std::string name;
+  std::string input;
+
+  // calls in each sample, and units of work in each call
+  std::size_t iterations {};
+  std::size_t operations {};
+
+  // nanoseconds per operation, one per repetition
+  std::vector<double> times {};
+
+  double median {};
+  double mad {};
+  double min {};
+  double max {};
+
+  // only for the JSON, as hyperfine reports them
+  double mean {};
+  double stddev {};
+
+  // CPU nanoseconds per operation, averaged over the repetitions
+  double user {};
+  double system {};
+};
+
+// keep the compiler from discarding value, or the work that made it
+template <typename T>
+void do_not_optimize(const T& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+auto median_of(std::vector<double> values) -> double
+{
+  if ( values.empty() ) {
+    return 0;
+  }
+
+  const std::size_t middle {values.size() / 2};
+  const auto middle_element {values.begin()
+                             + static_cast<std::ptrdiff_t>(middle)};
+
+  std::ranges::nth_element(values, middle_element);
+  const double upper {*middle_element};
+
+  if ( values.size() % 2 == 1 ) {
+    return upper;
+  }
+
+  // every element before the middle one is no greater than it
+  const double lower {*std::max_element(values.begin(), middle_element)};
+  return (lower + upper) / 2;
+}
+
+// call body iterations times, returning how long that took
+template <typename Body>
+auto time_batch(Body& body, const std::size_t iterations)
+  -> std::chrono::nanoseconds
+{
+  const auto start {std::chrono::steady_clock::now()};
+  for ( std::size_t i {0}; i < iterations; ++i ) {
+    body();
+  }
+  return std::chrono::steady_clock::now() - start;
+}
+
+// user and system CPU time of the process so far
+auto cpu_times() noexcept
+  -> std::pair<std::chrono::nanoseconds, std::chrono::nanoseconds>
+{
+  ::rusage usage {};
+  ::getrusage(RUSAGE_SELF, &usage);
+
+  const auto to_duration {[](const ::timeval time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::seconds {time.tv_sec}
+      + std::chrono::microseconds {time.tv_usec});
+  }};
+
+  return {to_duration(usage.ru_utime), to_duration(usage.ru_stime)};
+}
+
+// body does operations units of work per call
+template <typename Body>
+auto measure(const bench_options& options,
+             std::string name,
+             std::string input,
+             const std::size_t operations,
+             Body&& body) -> bench_result
+{
+  std::size_t iterations {1};
+  while ( time_batch(body, iterations) < options.min_sample_time
+          && iterations < (std::size_t {1} << 30) ) {
+    iterations *= 2;
+  }
+
+  for ( std::size_t i {0}; i < options.warmup; ++i ) {
+    static_cast<void>(time_batch(body, iterations));
+  }
+
+  bench_result result {
+    std::move(name), std::move(input), iterations, operations};
+
+  const auto per_operation {[&](const std::chrono::nanoseconds time) {
+    return static_cast<double>(time.count())
+         / static_cast<double>(iterations * operations);
+  }};
+
+  const auto [start_user, start_system] {cpu_times()};
+
+  for ( std::size_t i {0}; i < options.repetitions; ++i ) {
+    result.times.push_back(per_operation(time_batch(body, iterations)));
+  }
+
+  const auto [end_user, end_system] {cpu_times()};
+  const auto repetitions {static_cast<double>(options.repetitions)};
+  result.user = per_operation(end_user - start_user) / repetitions;
+  result.system = per_operation(end_system - start_system) / repetitions;
+
+  result.median = median_of(result.times);
+
+  std::vector<double> deviations {};
+  for ( const double time : result.times ) {
+    deviations.push_back(std::abs(time - result.median));
+  }
+  result.mad = median_of(std::move(deviations));
+
+  const auto [min, max] {std::ranges::minmax(result.times)};
+  result.min = min;
+  result.max = max;
+
+  double sum {};
+  for ( const double time : result.times ) {
+    sum += time;
+  }
+  result.mean = sum / static_cast<double>(result.times.size());
+
+  // the sample standard deviation, as hyperfine takes it
+  double squares {};
+  for ( const double time : result.times ) {
+    squares += (time - result.mean) * (time - result.mean);
+  }
+  result.stddev =
+    result.times.size() < 2
+      ? 0
+      : std::sqrt(squares / static_cast<double>(result.times.size() - 1));
+
+  return result;
+}
+
+template <unsigned BoxSize>
+void bench_board(const bench_options& options,
+                 const basic_sudoku<BoxSize>& board,
+                 const std::string& input,
+                 std::vector<bench_result>& results)
+{
+  using board_t = basic_sudoku<BoxSize>;
+  constexpr unsigned side {board_t::side};
+
+  results.push_back(measure(options, "is_valid", input, 1, [&board]() {
+    do_not_optimize(board.is_valid());
+  }));
+
+  // every digit in every cell, so no answer can be hoisted
+  const auto try_every_assignment {[&board]() {
+    for ( unsigned row {0}; row < side; ++row ) {
+      for ( unsigned col {0}; col < side; ++col ) {
+        for ( unsigned digit {0}; digit < side; ++digit ) {
+          do_not_optimize(board.is_legal_assignment(
+            {row, col}, board_t::digit_symbol(digit)));
+        }
+      }
+    }
+  }};
+
+  results.push_back(measure(options,
+                            "is_legal_assignment",
+                            input,
+                            board_t::cell_count * side,
+                            try_every_assignment));
+
+  if constexpr ( BoxSize == 3 ) {
+    results.push_back(
+      measure(options, "query_domains", input, 1, [&board]() {
+        do_not_optimize(board.query_domains());
+      }));
+  }
+
+  // both of these change the board, so start from a fresh copy each call
+  results.push_back(
+    measure(options, "apply_trivial_move", input, 1, [&board]() {
+      board_t copy {board};
+      do_not_optimize(copy.apply_trivial_move());
+      do_not_optimize(copy);
+    }));
+
+  for ( const auto& strategy : basic_search_strategies<BoxSize> ) {
+    const std::string name {"solve " + std::string {strategy.flag}};
+
+    // past 9x9 there is no exact cover engine,
+    // and only the strongest strategy finishes in reasonable time
+    if constexpr ( BoxSize == 3 ) {
+      solver_context context {};
+
+      results.push_back(
+        measure(options, name, input, 1, [&board, &strategy, &context]() {
+          Sudoku copy {board};
+          do_not_optimize(context.solve(copy, strategy));
+          do_not_optimize(copy);
+        }));
+    } else if ( strategy.flag == "--hidden" ) {
+      results.push_back(
+        measure(options, name, input, 1, [&board, &strategy]() {
+          board_t copy {board};
+          do_not_optimize(copy.solve(strategy.optimization_callback,
+                                     strategy.selection_callback));
+          do_not_optimize(copy);
+        }));
+    }
+  }
+}
+
+// a malformed file is reported and skipped
+template <unsigned BoxSize>
+void bench_file(const bench_options& options,
+                const std::string& contents,
+                const std::string& input,
+                std::vector<bench_result>& results)
+{
+  const auto [board, error] {parse_board<BoxSize>(contents)};
+
+  if ( ! board.has_value() ) {
+    std::cerr << "Skipping \"" << input << "\": " << error << '\n';
+    return;
+  }
+
+  bench_board(options, *board, input, results);
+}
+
+// every .dat file under the inputs directory, in a stable order
+auto find_inputs(const std::filesystem::path& directory)
+  -> std::vector<std::filesystem::path>
+{
+  std::vector<std::filesystem::path> paths {};
+  std::error_code error {};
+  const std::filesystem::recursive_directory_iterator files {directory,
+                                                             error};
+
+  for ( const auto& entry : files ) {
+    if ( entry.is_regular_file() && entry.path().extension() == ".dat" ) {
+      paths.push_back(entry.path());
+    }
+  }
+
+  std::ranges::sort(paths);
+  return paths;
+}
+
+void print_table(std::ostream& out,
+                 const std::vector<bench_result>& results)
+{
+  out << std::left << std::setw(22) << "benchmark" << std::setw(34)
+      << "input" << std::right << std::setw(14) << "median [ns]"
+      << std::setw(12) << "MAD [ns]" << std::setw(8) << "MAD %"
+      << std::setw(12) << "iterations" << '\n';
+
+  out << std::fixed;
+
+  for ( const bench_result& result : results ) {
+    out << std::left << std::setw(22) << result.name << std::setw(34)
+        << result.input << std::right << std::setprecision(1)
+        << std::setw(14) << result.median << std::setw(12) << result.mad
+        << std::setw(8)
+        << (result.median > 0 ? 100 * result.mad / result.median : 0.0)
+        << std::setw(12) << result.iterations << '\n';
+  }
+}
+
+void write_json_string(std::ostream& out, const std::string_view text)
+{
+  out << '"';
+  for ( const char symbol : text ) {
+    if ( symbol == '"' || symbol == '\\' ) {
+      out << '\\';
+    }
+    out << symbol;
+  }
+  out << '"';
+}
+
+// laid out as hyperfine's --export-json, in written_portion/data.json,
+// so that tools reading that read this too:
+// each benchmark on each input is a command, named "<name> <input>",
+// each repetition is a run, and times are in seconds per operation.
+// The benchmark and the input's name are the parameters "benchmark"
+// and "puzzle". What hyperfine has no place for follows its keys.
+void write_json(std::ostream& out,
+                const std::vector<bench_result>& results)
+{
+  // nanoseconds per operation to seconds, to six significant figures
+  const auto write_seconds {[&out](const double nanoseconds) {
+    out << std::defaultfloat << std::setprecision(6) << nanoseconds * 1e-9;
+  }};
+
+  out << "{\n  \"results\": [";
+
+  for ( std::size_t i {0}; i < results.size(); ++i ) {
+    const bench_result& result {results[i]};
+
+    out << (i == 0 ? "\n" : ",\n") << "    {\n      \"command\": ";
+    write_json_string(out, result.name + ' ' + result.input);
+
+    out << ",\n      \"mean\": ";
+    write_seconds(result.mean);
+    out << ",\n      \"stddev\": ";
+    if ( result.times.size() < 2 ) {
+      out << "null";
+    } else {
+      write_seconds(result.stddev);
+    }
+    out << ",\n      \"median\": ";
+    write_seconds(result.median);
+    out << ",\n      \"user\": ";
+    write_seconds(result.user);
+    out << ",\n      \"system\": ";
+    write_seconds(result.system);
+    out << ",\n      \"min\": ";
+    write_seconds(result.min);
+    out << ",\n      \"max\": ";
+    write_seconds(result.max);
+
+    out << ",\n      \"times\": [";
+    for ( std::size_t j {0}; j < result.times.size(); ++j ) {
+      out << (j == 0 ? "" : ", ");
+      write_seconds(result.times[j]);
+    }
+
+    // every run of a benchmark succeeds
+    out << "],\n      \"exit_codes\": [";
+    for ( std::size_t j {0}; j < result.times.size(); ++j ) {
+      out << (j == 0 ? "0" : ", 0");
+    }
+
+    out << "],\n      \"parameters\": {\"benchmark\": ";
+    write_json_string(out, result.name);
+    out << ", \"puzzle\": ";
+    write_json_string(out, puzzle_name(result.input));
+    out << "},\n      \"input\": ";
+    write_json_string(out, result.input);
+    out << ",\n      \"iterations\": " << result.iterations
+        << ",\n      \"operations\": " << result.operations
+        << ",\n      \"mad\": ";
+    write_seconds(result.mad);
+
+    out << "\n    }";
+  }
+
+  out << "\n  ]\n}\n";
+}
+
+void print_help_message(const char* const name)
+{
+  std::cerr << "Usage:\n"
+            << name
+            << " [--inputs DIR] [--json FILE] [--warmup N]"
+               " [--repetitions N] [--min-time-us N]\n"
+            << "A --json FILE of - writes JSON to stdout"
+               " instead of the table.\n";
+}
+
+auto parse_count(const std::string_view arg) -> std::optional<std::size_t>
+{
+  std::size_t number {};
+  const auto [end, error] {
+    std::from_chars(arg.data(), arg.data() + arg.size(), number)};
+
+  if ( error != std::errc {} || end != arg.data() + arg.size() ) {
+    return std::nullopt;
+  }
+
+  return number;
+}
+
+auto parse_options(const int argc, const char* const* const argv)
+  -> std::optional<bench_options>
+{
+  using namespace std::literals;  // for operator""sv string_view literal
+
+  bench_options options {};
+
+  // the options come in pairs
+  if ( argc % 2 != 1 ) {
+    return std::nullopt;
+  }
+
+  for ( int i {1}; i < argc; i += 2 ) {
+    const std::string_view option {argv[i]};
+    const std::string_view value {argv[i + 1]};
+
+    if ( option == "--inputs"sv ) {
+      options.inputs = value;
+      continue;
+    }
+
+    if ( option == "--json"sv ) {
+      options.json_path = std::string {value};
+      continue;
+    }
+
+    const auto number {parse_count(value)};
+
+    if ( ! number.has_value() ) {
+      std::cerr << "Bad value for " << option << ": \"" << value << "\"\n";
+      return std::nullopt;
+    }
+
+    if ( option == "--warmup"sv ) {
+      options.warmup = *number;
+    } else if ( option == "--repetitions"sv && *number > 0 ) {
+      options.repetitions = *number;
+    } else if ( option == "--min-time-us"sv ) {
+      options.min_sample_time = std::chrono::microseconds {*number};
+    } else {
+      std::cerr << "Bad option: \"" << option << "\"\n";
+      return std::nullopt;
+    }
+  }
+
+  return options;
+}
+}  // namespace
+
+auto main(const int argc, const char* const* const argv) -> int
+{
+  const std::optional<bench_options> options {parse_options(argc, argv)};
+
+  if ( ! options.has_value() ) {
+    print_help_message(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const std::vector<std::filesystem::path> inputs {
+    find_inputs(options->inputs)};
+
+  if ( inputs.empty() ) {
+    std::cerr << "No .dat files in: " << options->inputs << '\n';
+    return EXIT_FAILURE;
+  }
+
+  std::vector<bench_result> results {};
+
+  for ( const std::filesystem::path& path : inputs ) {
+    std::ifstream infile {path};
+    std::ostringstream buffer;
+    buffer << infile.rdbuf();
+    const std::string contents {std::move(buffer).str()};
+
+    const std::string input {
+      std::filesystem::relative(path, options->inputs).string()};
+
+    switch ( count_cell_symbols(contents) ) {
+      case board_shape<2>::cell_count:
+        bench_file<2>(*options, contents, input, results);
+        break;
+      case board_shape<4>::cell_count:
+        bench_file<4>(*options, contents, input, results);
+        break;
+      case board_shape<5>::cell_count:
+        bench_file<5>(*options, contents, input, results);
+        break;
+      default:
+        bench_file<3>(*options, contents, input, results);
+        break;
+    }
+  }
+
+  if ( options->json_path == "-" ) {
+    write_json(std::cout, results);
+    return EXIT_SUCCESS;
+  }
+
+  print_table(std::cout, results);
+
+  if ( options->json_path.has_value() ) {
+    std::ofstream json {*options->json_path};
+
+    if ( ! json.is_open() ) {
+      std::cerr << "Error opening file: \"" << *options->json_path
+                << "\"\n";
+      return EXIT_FAILURE;
+    }
+
+    write_json(json, results);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+
+#include "corpus_reader.hpp"
+#include "strategy.hpp"
+
+struct batch_report {
+  std::size_t puzzle_count {};
+
+  // puzzles which were malformed or had no solution
+  std::size_t failure_count {};
+
+  std::chrono::nanoseconds elapsed {};
+
+  std::size_t thread_count {1};
+
+  friend inline auto operator<<(std::ostream& out,
+                                const batch_report& rhs) noexcept
+    -> std::ostream&
+  {
+    const auto seconds {
+      std::chrono::duration<double> {rhs.elapsed}.count()};
+
+    out << "Threads: " << rhs.thread_count << '\n'
+        << "Puzzles: " << rhs.puzzle_count << '\n'
+        << "Failures: " << rhs.failure_count << '\n'
+        << "Took: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(
+             rhs.elapsed)
+             .count()
+        << "us\n"
+        << "Puzzles per second: "
+        << (seconds > 0 ? static_cast<double>(rhs.puzzle_count) / seconds
+                        : 0.0)
+        << '\n';
+    return out;
+  }
+};
+
+// starts the output line of a puzzle which could not be solved,
+// so that a full but invalid grid is not taken for a solution
+constexpr inline std::string_view batch_failure_prefix {"unsolved: "};
+
+// Solve every puzzle of a corpus, one puzzle per line
+// (see Sudoku::from_line)
+//
+// One line is written to out for every puzzle read:
+// the solution, or if it could not be solved,
+// batch_failure_prefix followed by the input line.
+// Blank lines are skipped.
+// Lines are parsed where the reader left them, never copied.
+auto solve_batch(corpus_reader& in,
+                 std::ostream& out,
+                 const search_strategy& strategy) -> batch_report;
+
+// As solve_batch, spread over a pool of worker threads
+//
+// Puzzles are handed out in blocks of lines from the reader,
+// each worker solving with its own solver_context,
+// and output is written in input order.
+// A thread_count of 0 means one thread per hardware thread.
+auto solve_batch_parallel(corpus_reader& in,
+                          std::ostream& out,
+                          const search_strategy& strategy,
+                          std::size_t thread_count) -> batch_report;
+
+// Rate every puzzle of a corpus, one puzzle per line (see rate)
+//
+// One line is written to out for every puzzle read, tab separated:
+// the input line, its difficulty tier, the hardest technique it needed,
+// the cells left for a search, and the search space left in bits.
+// Puzzles which are malformed or have no solution count as failures.
+// A thread_count other than 1 spreads the work as solve_batch_parallel
+// does, 0 meaning one thread per hardware thread.
+//
+// Given a strategy, each puzzle is then solved with it,
+// carrying on from the rater's deductions rather than starting over,
+// and its solution, or "none", is written as a sixth field.
+auto rate_batch(corpus_reader& in,
+                std::ostream& out,
+                std::size_t thread_count,
+                const search_strategy* strategy = nullptr)
+  -> batch_report;
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef BOARD_PARSER_HPP
+#define BOARD_PARSER_HPP
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+#include "sudoku.hpp"
+
+enum class parse_error_kind {
+  none,
+
+  // neither a cell nor a separator
+  bad_character,
+
+  // the text ran out before the board was full
+  too_few_cells,
+
+  // a cell after the board was full
+  too_many_cells,
+};
+
+// Where and why text could not be read as a board
+struct parse_error {
+  parse_error_kind kind {parse_error_kind::none};
+
+  // of the offending character,
+  // or the length of the text if there were too few cells
+  std::size_t offset {};
+
+  // the same position counted from 1, for people
+  std::size_t line {};
+  std::size_t column {};
+
+  // the offending character, if there was one
+  char character {};
+
+  // cells read before the error
+  std::size_t cell_count {};
+};
+
+// "line L, column C: " and what went wrong
+auto operator<<(std::ostream& out, const parse_error& rhs)
+  -> std::ostream&;
+
+template <unsigned BoxSize>
+struct board_parse_result {
+  // empty if the text was malformed
+  std::optional<basic_sudoku<BoxSize>> board {};
+
+  // kind is parse_error_kind::none if board holds a value
+  parse_error error {};
+};
+
+// Read a board from text, in any of the common formats:
+// one line of cells, a grid of whitespace separated cells,
+// or a grid with lines drawn between boxes, as operator<< writes
+//
+// Cells are digits (see basic_sudoku::charset),
+// or '.', '0', or '_' for an empty cell, in row-major order.
+// Anything else must be a separator (see is_separator_symbol),
+// and is skipped.
+//
+// Where the instruction set allows, text is classified 16 or 32 bytes
+// at a time, falling back to one byte at a time only around separators
+// and errors.
+template <unsigned BoxSize>
+[[nodiscard]] auto parse_board(std::string_view text) noexcept
+  -> board_parse_result<BoxSize>;
+
+// the characters of text which are not separators,
+// so the cells of a board of whichever size text holds
+[[nodiscard]] auto count_cell_symbols(std::string_view text) noexcept
+  -> std::size_t;
+
+#endif
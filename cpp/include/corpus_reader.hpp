@@ -0,0 +1,141 @@
+#ifndef CORPUS_READER_HPP
+#define CORPUS_READER_HPP
+
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// spaces, tabs, and carriage returns only
+[[nodiscard]] constexpr auto is_blank_line(
+  const std::string_view line) noexcept -> bool
+{
+  return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+// A run of whole lines of a corpus
+//
+// The text is a view into the corpus_reader's mapping,
+// or into storage, when it had to be read rather than mapped.
+// Either way a block stays valid when moved, so blocks may be handed
+// to other threads, but a mapped one must not outlive its reader.
+// A copy's text would still point into the original's storage,
+// so blocks may only be moved.
+struct corpus_block {
+  std::string_view text {};
+
+  // lines of text which are not blank
+  std::size_t line_count {};
+
+  std::vector<char> storage {};
+
+  corpus_block() = default;
+  corpus_block(const corpus_block&) = delete;
+  corpus_block(corpus_block&&) noexcept = default;
+  auto operator=(const corpus_block&) -> corpus_block& = delete;
+  auto operator=(corpus_block&&) noexcept -> corpus_block& = default;
+  ~corpus_block() = default;
+
+  // call visit with every line which is not blank, without its newline
+  template <typename Visitor>
+  void for_each_line(Visitor&& visit) const
+  {
+    std::string_view rest {text};
+
+    while ( ! rest.empty() ) {
+      const std::size_t end {rest.find('\n')};
+      const std::string_view line {rest.substr(0, end)};
+
+      if ( ! is_blank_line(line) ) {
+        visit(line);
+      }
+
+      if ( end == std::string_view::npos ) {
+        break;
+      }
+      rest.remove_prefix(end + 1);
+    }
+  }
+};
+
+// Reads a corpus of one-line puzzles a block of lines at a time
+//
+// A regular file is mapped into memory, with the kernel told to expect
+// sequential access, and blocks are views into the mapping,
+// so nothing is copied on the way to the parser.
+// Anything which cannot be mapped, like a pipe, is read with read()
+// into each block's own storage instead, as is a std::istream.
+class corpus_reader
+{
+private:
+
+  // the whole corpus, when mapped or borrowed
+  std::string_view m_contents {};
+  std::size_t m_position {0};
+  bool m_is_mapped {false};
+
+  // otherwise read from one of these
+  int m_descriptor {-1};
+  bool m_owns_descriptor {false};
+  std::istream* m_stream {nullptr};
+
+  // read but not yet handed out from m_buffer_start on
+  std::vector<char> m_buffer {};
+  std::size_t m_buffer_start {0};
+  bool m_at_end {false};
+  bool m_failed {false};
+
+  explicit corpus_reader(int descriptor, bool owns_descriptor) noexcept;
+
+  auto next_contents_block(std::size_t max_lines) noexcept
+    -> corpus_block;
+  auto next_read_block(std::size_t max_lines) -> corpus_block;
+
+  // read more of the corpus onto the end of m_buffer,
+  // returning false at the end or on failure
+  auto read_more() -> bool;
+
+  void release() noexcept;
+
+public:
+
+  // nothing if path cannot be opened
+  [[nodiscard]] static auto open(const char* path)
+    -> std::optional<corpus_reader>;
+
+  // read from an open descriptor, like standard input,
+  // which is left open
+  [[nodiscard]] static auto from_descriptor(int descriptor) noexcept
+    -> corpus_reader;
+
+  // contents must outlive the reader and its blocks
+  explicit corpus_reader(std::string_view contents) noexcept;
+
+  // in must outlive the reader
+  explicit corpus_reader(std::istream& in) noexcept;
+
+  corpus_reader(const corpus_reader&) = delete;
+  corpus_reader(corpus_reader&& other) noexcept;
+  auto operator=(const corpus_reader&) -> corpus_reader& = delete;
+  auto operator=(corpus_reader&& other) noexcept -> corpus_reader&;
+  ~corpus_reader();
+
+  // up to max_lines lines which are not blank, and any blank lines
+  // among them, with text empty once the corpus is finished
+  [[nodiscard]] auto next_block(std::size_t max_lines) -> corpus_block;
+
+  // whether reading stopped early on an error,
+  // rather than at the end of the corpus
+  [[nodiscard]] auto failed() const noexcept -> bool
+  {
+    return m_failed;
+  }
+
+  [[nodiscard]] auto is_mapped() const noexcept -> bool
+  {
+    return m_is_mapped;
+  }
+};
+
+#endif
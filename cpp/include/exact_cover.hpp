@@ -0,0 +1,86 @@
+#ifndef EXACT_COVER_HPP
+#define EXACT_COVER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "search_stats.hpp"
+#include "sudoku.hpp"
+
+// Alternative solving engine: Knuth's Algorithm X with Dancing Links
+// See https://arxiv.org/abs/cs/0011047 for details
+//
+// Sudoku is encoded as an exact cover problem of 729 rows,
+// one per (cell, digit) pair, over 324 constraint columns:
+//    81 cells, each must hold a digit
+//    81 (row, digit) pairs, each digit once per row
+//    81 (column, digit) pairs, each digit once per column
+//    81 (box, digit) pairs, each digit once per box
+//
+// Every row covers exactly 4 columns.
+// Nodes live in one fixed pool and link to each other by index,
+// so a solve makes no heap allocations.
+class exact_cover_solver
+{
+public:
+
+  constexpr static std::size_t column_count {324};
+  constexpr static std::size_t row_count {729};
+
+  // root header, column headers, then 4 nodes per row
+  constexpr static std::size_t node_count {1 + column_count
+                                           + row_count * 4};
+
+private:
+
+  using node_index = std::uint16_t;
+
+  std::array<node_index, node_count> m_left {};
+  std::array<node_index, node_count> m_right {};
+  std::array<node_index, node_count> m_up {};
+  std::array<node_index, node_count> m_down {};
+
+  // column header of each node
+  std::array<node_index, node_count> m_column {};
+
+  // number of rows remaining in each column, indexed by header
+  std::array<node_index, 1 + column_count> m_size {};
+
+  // rows selected so far, one per assigned cell
+  std::array<node_index, 81> m_solution {};
+
+  std::size_t m_row_selection_count {};
+
+  // for the solve in progress, and the depth its search started at,
+  // past the rows of the clues
+  search_stats* m_stats {nullptr};
+  std::size_t m_first_depth {};
+
+  void link_matrix() noexcept;
+
+  void cover(node_index column) noexcept;
+  void uncover(node_index column) noexcept;
+
+  void select_row(node_index node) noexcept;
+  void deselect_row(node_index node) noexcept;
+
+  auto search(std::size_t depth) noexcept -> bool;
+
+public:
+
+  exact_cover_solver() = default;
+
+  // same contract as Sudoku::solve:
+  // returns the number of rows tried and whether a solution was found,
+  // sudoku is only modified when a solution is found
+  //
+  // covering columns does the work of forcing moves,
+  // so stats count no forced moves, and the whole search as branching
+  [[nodiscard]] auto solve(Sudoku& sudoku,
+                           search_stats* stats = nullptr) noexcept
+    -> std::pair<std::size_t, bool>;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string_view>
+
+#include "sudoku.hpp"
+
+// cells which must be all clues or all blanks together
+enum class symmetry {
+  none,
+
+  // half turn about the center
+  rotational,
+
+  // reflection across the middle column
+  mirror,
+
+  // reflection across the main diagonal
+  diagonal,
+
+  // every rotation and reflection of the square
+  dihedral,
+};
+
+[[nodiscard]] auto parse_symmetry(std::string_view name) noexcept
+  -> std::optional<symmetry>;
+
+struct generator_options {
+  // clues are removed until no more can be while keeping the solution
+  // unique, or until only this many are left
+  std::size_t target_clue_count {0};
+
+  symmetry pattern {symmetry::none};
+
+  // fresh complete grids tried when one cannot be brought down to
+  // target_clue_count, the puzzle with the fewest clues being kept
+  std::size_t attempt_count {4};
+};
+
+// A random puzzle with exactly one solution
+//
+// A random complete grid is built, then clues are removed,
+// each orbit of the symmetry pattern at a time in random order,
+// keeping a removal only while the solution stays unique.
+// Uniqueness is checked by counting solutions up to 2.
+//
+// Only rng supplies randomness, so the same seed gives the same puzzle.
+[[nodiscard]] auto generate_puzzle(std::mt19937_64& rng,
+                                   const generator_options& options)
+  -> Sudoku;
+
+struct generation_report {
+  std::size_t puzzle_count {};
+
+  // puzzles left with more than the target number of clues
+  std::size_t missed_target_count {};
+
+  std::size_t clue_count {};
+
+  std::chrono::nanoseconds elapsed {};
+
+  std::size_t thread_count {1};
+
+  friend inline auto operator<<(std::ostream& out,
+                                const generation_report& rhs) noexcept
+    -> std::ostream&
+  {
+    const auto seconds {
+      std::chrono::duration<double> {rhs.elapsed}.count()};
+
+    out << "Threads: " << rhs.thread_count << '\n'
+        << "Puzzles: " << rhs.puzzle_count << '\n'
+        << "Missed target: " << rhs.missed_target_count << '\n'
+        << "Average clues: "
+        << (rhs.puzzle_count > 0
+              ? static_cast<double>(rhs.clue_count)
+                  / static_cast<double>(rhs.puzzle_count)
+              : 0.0)
+        << '\n'
+        << "Took: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(
+             rhs.elapsed)
+             .count()
+        << "us\n"
+        << "Puzzles per second: "
+        << (seconds > 0 ? static_cast<double>(rhs.puzzle_count) / seconds
+                        : 0.0)
+        << '\n';
+    return out;
+  }
+};
+
+// Write puzzle_count puzzles to out, one per line
+// (see Sudoku::from_line), spread over a pool of worker threads
+//
+// Puzzles are made in fixed-size chunks, the generator of each chunk
+// seeded from seed and the chunk's position,
+// so the output depends only on the seed and the options,
+// never on thread_count or on scheduling.
+// A thread_count of 0 means one thread per hardware thread.
+auto generate_batch(std::ostream& out,
+                    std::size_t puzzle_count,
+                    std::uint64_t seed,
+                    const generator_options& options,
+                    std::size_t thread_count) -> generation_report;
+
+#endif
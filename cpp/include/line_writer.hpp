@@ -0,0 +1,99 @@
+#ifndef LINE_WRITER_HPP
+#define LINE_WRITER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <utility>
+
+// Collects output lines in one large buffer,
+// handing them to the stream's buffer a full block at a time
+//
+// For output made of very many short lines,
+// where going through std::ostream for each would dominate.
+// Whatever is left is written when the writer is flushed or destroyed.
+class line_writer
+{
+public:
+
+  constexpr static std::size_t default_capacity {std::size_t {1} << 20};
+
+private:
+
+  std::streambuf* m_out;
+  std::unique_ptr<char[]> m_buffer;
+  std::size_t m_capacity;
+  std::size_t m_size {0};
+
+public:
+
+  explicit line_writer(std::ostream& out,
+                       const std::size_t capacity = default_capacity)
+      : m_out {out.rdbuf()}
+      , m_buffer {std::make_unique_for_overwrite<char[]>(capacity)}
+      , m_capacity {capacity}
+  { }
+
+  line_writer(const line_writer&) = delete;
+  line_writer(line_writer&&) = delete;
+  auto operator=(const line_writer&) -> line_writer& = delete;
+  auto operator=(line_writer&&) -> line_writer& = delete;
+
+  ~line_writer()
+  {
+    flush();
+  }
+
+  // line is written followed by a newline
+  void write_line(const std::string_view line)
+  {
+    if ( m_size + line.size() + 1 > m_capacity ) {
+      flush();
+
+      // too long to ever be buffered
+      if ( line.size() + 1 > m_capacity ) {
+        m_out->sputn(line.data(),
+                     static_cast<std::streamsize>(line.size()));
+        m_out->sputc('\n');
+        return;
+      }
+    }
+
+    line.copy(m_buffer.get() + m_size, line.size());
+    m_size += line.size();
+    m_buffer[m_size] = '\n';
+    ++m_size;
+  }
+
+  // size bytes written in place by fill,
+  // which is handed a pointer to where they go in the buffer,
+  // so that formatted output needs no copy of its own
+  //
+  // the buffer grows if it could never hold size bytes
+  template <typename Filler>
+  void write_with(const std::size_t size, Filler&& fill)
+  {
+    if ( m_size + size > m_capacity ) {
+      flush();
+
+      if ( size > m_capacity ) {
+        m_buffer = std::make_unique_for_overwrite<char[]>(size);
+        m_capacity = size;
+      }
+    }
+
+    std::forward<Filler>(fill)(m_buffer.get() + m_size);
+    m_size += size;
+  }
+
+  void flush()
+  {
+    m_out->sputn(m_buffer.get(), static_cast<std::streamsize>(m_size));
+    m_out->pubsync();
+    m_size = 0;
+  }
+};
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef PACKED_CORPUS_HPP
+#define PACKED_CORPUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "batch.hpp"
+#include "corpus_reader.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+// A compact, seekable file of 9x9 puzzles, and optionally their solutions
+//
+// A record is an 81-bit map of which cells are clues,
+// then a digit per 4 bits: the clues in row-major order, followed,
+// if the file holds solutions, by the solution's digits for the blank
+// cells (all 0 if there was none).
+// A 25 clue puzzle takes 24 bytes, against 82 for a line of text,
+// and a puzzle with its solution always 52, against 164.
+//
+// Records are grouped into blocks of up to block_capacity,
+// each starting with the 16-bit offsets of its records and checked
+// by a CRC-32 kept in an index at the end of the file.
+// Puzzle n is in block n / block_capacity, at an offset read from the
+// block's table, so reaching any puzzle takes a constant number of reads.
+//
+// All integers are little-endian. The file is laid out as
+//
+//   header   "SUDOKUPK", u16 version, u16 flags, u32 block_capacity
+//   blocks   u16 offsets[records + 1], records
+//   index    per block: u64 file offset, u32 size, u32 CRC-32
+//   trailer  u64 index offset, u64 puzzle count, "SUDOKUPK"
+//
+// The index follows the blocks, so a file can be written in one pass,
+// to a pipe as well as to a file.
+struct packed_format {
+  constexpr static std::string_view magic {"SUDOKUPK"};
+  constexpr static std::uint16_t version {1};
+
+  // flags
+  constexpr static std::uint16_t has_solutions {1};
+
+  constexpr static std::size_t header_size {16};
+  constexpr static std::size_t index_entry_size {16};
+  constexpr static std::size_t trailer_size {24};
+
+  // small enough that every offset in a block fits in 16 bits
+  constexpr static std::size_t block_capacity {1024};
+
+  // the clue map, and a digit for every cell
+  constexpr static std::size_t max_record_size {11 + 41};
+};
+
+// CRC-32 as used by zlib and PNG
+[[nodiscard]] auto crc32(std::string_view bytes) noexcept
+  -> std::uint32_t;
+
+struct packed_entry {
+  Sudoku puzzle {};
+
+  // empty if the file holds no solutions, or none was stored for this one
+  // a puzzle with no blank cells always counts as its own solution
+  std::optional<Sudoku> solution {};
+};
+
+// Writes a packed corpus to out, a block at a time
+//
+// Nothing is complete until finish is called, which the destructor does
+// if it has not been already. out is not checked; test it afterwards.
+// The destructor cannot report a failure, so it swallows any exception
+// finish throws: call finish to see them.
+class packed_corpus_writer
+{
+private:
+
+  std::ostream* m_out;
+  bool m_with_solutions;
+
+  // the block being built, records and their offsets apart
+  std::vector<char> m_records {};
+  std::vector<std::uint16_t> m_offsets {};
+
+  struct index_entry {
+    std::uint64_t offset;
+    std::uint32_t size;
+    std::uint32_t checksum;
+  };
+
+  std::vector<index_entry> m_index {};
+
+  std::uint64_t m_position {0};
+  std::uint64_t m_puzzle_count {0};
+  bool m_finished {false};
+
+  void write_block();
+
+public:
+
+  packed_corpus_writer(std::ostream& out, bool with_solutions);
+
+  packed_corpus_writer(const packed_corpus_writer&) = delete;
+  packed_corpus_writer(packed_corpus_writer&&) = delete;
+  auto operator=(const packed_corpus_writer&)
+    -> packed_corpus_writer& = delete;
+  auto operator=(packed_corpus_writer&&) -> packed_corpus_writer& = delete;
+
+  ~packed_corpus_writer() noexcept;
+
+  // solution is ignored unless the writer was made with_solutions,
+  // and must agree with every clue of puzzle if given
+  void add(const Sudoku& puzzle,
+           const std::optional<Sudoku>& solution = std::nullopt);
+
+  // write the last block, the index, and the trailer
+  void finish();
+};
+
+// A packed corpus read in place, from a mapped file or borrowed bytes
+class packed_corpus
+{
+private:
+
+  std::string_view m_bytes {};
+  bool m_is_mapped {false};
+
+  bool m_with_solutions {false};
+  std::size_t m_block_capacity {};
+  std::size_t m_puzzle_count {};
+  std::string_view m_index {};
+
+  packed_corpus() = default;
+
+  void release() noexcept;
+
+  // the bytes of block number, or empty if the index is inconsistent
+  [[nodiscard]] auto block(std::size_t number) const noexcept
+    -> std::string_view;
+
+public:
+
+  // nullopt if the file cannot be read, or is not a packed corpus
+  [[nodiscard]] static auto open(const char* path)
+    -> std::optional<packed_corpus>;
+
+  // as open, for bytes which must outlive the corpus
+  [[nodiscard]] static auto from_bytes(std::string_view bytes) noexcept
+    -> std::optional<packed_corpus>;
+
+  packed_corpus(const packed_corpus&) = delete;
+  packed_corpus(packed_corpus&& other) noexcept;
+  auto operator=(const packed_corpus&) -> packed_corpus& = delete;
+  auto operator=(packed_corpus&& other) noexcept -> packed_corpus&;
+
+  ~packed_corpus();
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    return m_puzzle_count;
+  }
+
+  [[nodiscard]] auto has_solutions() const noexcept -> bool
+  {
+    return m_with_solutions;
+  }
+
+  [[nodiscard]] auto block_count() const noexcept -> std::size_t
+  {
+    return m_index.size() / packed_format::index_entry_size;
+  }
+
+  // puzzles in every block but possibly the last
+  [[nodiscard]] auto block_capacity() const noexcept -> std::size_t
+  {
+    return m_block_capacity;
+  }
+
+  // whether block number matches its checksum
+  [[nodiscard]] auto verify_block(std::size_t number) const noexcept
+    -> bool;
+
+  // puzzle number, without checking its block's checksum
+  //
+  // nullopt if number is out of range or its record is malformed
+  [[nodiscard]] auto at(std::size_t number) const noexcept
+    -> std::optional<packed_entry>;
+};
+
+// Pack every puzzle of a text corpus, one per line (see Sudoku::from_line)
+//
+// With a strategy, each puzzle is solved and the solution stored as well.
+// Malformed lines are skipped, and they and puzzles with no solution
+// count as failures.
+auto pack_corpus(corpus_reader& in,
+                 std::ostream& out,
+                 const search_strategy* strategy) -> batch_report;
+
+// Write every puzzle of a packed corpus as a line of text,
+// or if with_solutions, its solution as solve_batch would:
+// a puzzle with none is written after batch_failure_prefix
+//
+// Each block is checked against its checksum first;
+// the puzzles of a block which fails count as failures, and are skipped.
+auto unpack_corpus(const packed_corpus& corpus,
+                   std::ostream& out,
+                   bool with_solutions) -> batch_report;
+
+#endif
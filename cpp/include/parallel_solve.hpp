@@ -0,0 +1,35 @@
+#ifndef PARALLEL_SOLVE_HPP
+#define PARALLEL_SOLVE_HPP
+
+#include <cstddef>
+#include <utility>
+
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+// branches a search may try on one thread before it is worth splitting
+//
+// all of the example inputs finish well within this
+// with any strategy but --simple
+constexpr inline std::size_t parallel_branch_threshold {1000};
+
+// Sudoku::solve for a single latency-critical puzzle,
+// spreading the search over several threads once it proves expensive
+//
+// The search first runs on the calling thread.
+// If it tries more than branch_threshold branches without finishing,
+// the branches it has not yet taken are split into subtrees,
+// which thread_count threads then search concurrently,
+// so none of the search already done is repeated.
+// The first thread to find a solution cancels all the others.
+//
+// Same contract as Sudoku::solve, though which solution is found
+// (if there are several) and the assignment count may differ.
+auto solve_parallel(Sudoku& sudoku,
+                    optimization_callback_t optimization_callback,
+                    selection_callback_t selection_callback,
+                    std::size_t thread_count,
+                    std::size_t branch_threshold)
+  -> std::pair<std::size_t, bool>;
+
+#endif
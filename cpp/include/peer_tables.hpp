@@ -0,0 +1,152 @@
+#ifndef PEER_TABLES_HPP
+#define PEER_TABLES_HPP
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Flat lookup tables of the board's geometry, generated at compile time
+// for a board of BoxSize x BoxSize boxes of BoxSize x BoxSize cells.
+// Cells are numbered row-major.
+// Units are numbered rows, then columns, then boxes,
+// boxes themselves being counted row-major.
+// Entries are as narrow as the board allows,
+// a single byte for every board up to 16x16.
+
+template <unsigned BoxSize>
+struct board_shape {
+  static_assert(BoxSize >= 2 && BoxSize <= 5,
+                "Supported boards are 4x4, 9x9, 16x16, and 25x25");
+
+  // cells per row, column, and box, as well as the number of digits
+  constexpr static unsigned side {BoxSize * BoxSize};
+  constexpr static unsigned cell_count {side * side};
+  constexpr static unsigned unit_count {side * 3};
+
+  // the rest of the cell's row and column,
+  // and the cells of its box in neither
+  constexpr static unsigned peer_count {
+    (side - 1) * 2 + (BoxSize - 1) * (BoxSize - 1)};
+
+  using cell_index_t = std::conditional_t<(cell_count <= 256),
+                                          std::uint8_t,
+                                          std::uint16_t>;
+
+  struct cell_position {
+    std::array<std::uint8_t, cell_count> rows;
+    std::array<std::uint8_t, cell_count> cols;
+    std::array<std::uint8_t, cell_count> boxes;
+  };
+
+  using unit_table = std::array<std::array<cell_index_t, side>, unit_count>;
+  using peer_table =
+    std::array<std::array<cell_index_t, peer_count>, cell_count>;
+};
+
+template <unsigned BoxSize>
+constexpr auto generate_cell_positions() noexcept ->
+  typename board_shape<BoxSize>::cell_position
+{
+  using shape = board_shape<BoxSize>;
+  typename shape::cell_position positions {};
+
+  for ( unsigned cell {0}; cell < shape::cell_count; ++cell ) {
+    const unsigned row {cell / shape::side};
+    const unsigned col {cell % shape::side};
+
+    positions.rows.at(cell) = static_cast<std::uint8_t>(row);
+    positions.cols.at(cell) = static_cast<std::uint8_t>(col);
+    positions.boxes.at(cell) = static_cast<std::uint8_t>(
+      (row / BoxSize) * BoxSize + col / BoxSize);
+  }
+
+  return positions;
+}
+
+template <unsigned BoxSize>
+constexpr auto generate_unit_cells() noexcept ->
+  typename board_shape<BoxSize>::unit_table
+{
+  using shape = board_shape<BoxSize>;
+  using cell_index_t = typename shape::cell_index_t;
+  constexpr unsigned side {shape::side};
+
+  typename shape::unit_table units {};
+
+  for ( unsigned i {0}; i < side; ++i ) {
+    for ( unsigned j {0}; j < side; ++j ) {
+      units.at(i).at(j) = static_cast<cell_index_t>(i * side + j);
+      units.at(side + i).at(j) = static_cast<cell_index_t>(j * side + i);
+
+      // box i is at box row (i / BoxSize) and box column (i % BoxSize),
+      // its cells are also counted row-major
+      const unsigned row {(i / BoxSize) * BoxSize + j / BoxSize};
+      const unsigned col {(i % BoxSize) * BoxSize + j % BoxSize};
+      units.at(side * 2 + i).at(j) =
+        static_cast<cell_index_t>(row * side + col);
+    }
+  }
+
+  return units;
+}
+
+template <unsigned BoxSize>
+constexpr auto generate_cell_peers() noexcept ->
+  typename board_shape<BoxSize>::peer_table
+{
+  using shape = board_shape<BoxSize>;
+  using cell_index_t = typename shape::cell_index_t;
+  constexpr unsigned side {shape::side};
+
+  typename shape::peer_table peers {};
+
+  for ( unsigned cell {0}; cell < shape::cell_count; ++cell ) {
+    const unsigned row {cell / side};
+    const unsigned col {cell % side};
+
+    auto& cell_peers {peers.at(cell)};
+    unsigned count {0};
+
+    // row by row, so the peers come out in ascending order
+    for ( unsigned peer_row {0}; peer_row < side; ++peer_row ) {
+      const bool same_band {peer_row / BoxSize == row / BoxSize};
+
+      for ( unsigned peer_col {0}; peer_col < side; ++peer_col ) {
+        const bool same_stack {peer_col / BoxSize == col / BoxSize};
+        const bool is_peer {peer_row == row || peer_col == col
+                            || (same_band && same_stack)};
+
+        if ( is_peer && (peer_row != row || peer_col != col) ) {
+          cell_peers.at(count++) =
+            static_cast<cell_index_t>(peer_row * side + peer_col);
+        }
+      }
+    }
+  }
+
+  return peers;
+}
+
+template <unsigned BoxSize>
+struct board_geometry : board_shape<BoxSize> {
+  // row, column, and box of every cell
+  constexpr static typename board_shape<BoxSize>::cell_position
+    positions {generate_cell_positions<BoxSize>()};
+
+  // cells of every unit
+  constexpr static typename board_shape<BoxSize>::unit_table units {
+    generate_unit_cells<BoxSize>()};
+
+  // the other cells sharing a row, column, or box with each cell,
+  // in ascending order
+  constexpr static typename board_shape<BoxSize>::peer_table peers {
+    generate_cell_peers<BoxSize>()};
+};
+
+// the standard 9x9 board
+
+constexpr inline const auto& cell_positions {board_geometry<3>::positions};
+constexpr inline const auto& unit_cells {board_geometry<3>::units};
+constexpr inline const auto& cell_peers {board_geometry<3>::peers};
+
+#endif
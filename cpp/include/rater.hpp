@@ -0,0 +1,100 @@
+#ifndef RATER_HPP
+#define RATER_HPP
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+// Logical deductions, from easiest to hardest
+enum class technique {
+  naked_single,
+  hidden_single,
+
+  // a digit confined to one line within a box,
+  // or to one box within a line
+  locked_candidates,
+
+  // N cells of a unit with only N digits between them
+  naked_pair,
+
+  // N digits of a unit with only N cells between them
+  hidden_pair,
+  naked_triple,
+  hidden_triple,
+  naked_quad,
+  hidden_quad,
+};
+
+constexpr inline std::size_t technique_count {
+  static_cast<std::size_t>(technique::hidden_quad) + 1};
+
+[[nodiscard]] auto technique_name(technique used) noexcept
+  -> std::string_view;
+
+// How hard a puzzle is to solve by hand, and how much is left to search
+struct difficulty_rating {
+  // false for an invalid board, or one the deductions prove unsolvable
+  bool consistent {true};
+
+  // times each technique was applied, indexed by technique
+  // a single placed a cell, anything harder eliminated candidates
+  std::array<std::size_t, technique_count> uses {};
+
+  // empty if the puzzle needed no deduction at all
+  std::optional<technique> hardest {};
+
+  // cells none of the techniques could fill, left for a search
+  std::size_t cells_left {};
+
+  // log2 of the product of the domain sizes of cells_left,
+  // an upper bound on the size of the search tree left
+  double search_space_bits {};
+
+  [[nodiscard]] auto solved_logically() const noexcept -> bool
+  {
+    return consistent && cells_left == 0;
+  }
+};
+
+// the tier, the hardest technique, the uses of each technique,
+// and what is left to search, one per line
+auto operator<<(std::ostream& out, const difficulty_rating& rhs)
+  -> std::ostream&;
+
+// Coarse grade of a rating, for routing puzzles by difficulty
+//
+// "easy" needs only singles, "medium" locked candidates,
+// "hard" subsets, and "search" cannot be finished by these techniques.
+// "invalid" puzzles have no solution.
+[[nodiscard]] auto difficulty_tier(
+  const difficulty_rating& rating) noexcept -> std::string_view;
+
+// Solve as far as possible by deduction alone,
+// always applying the easiest technique which makes progress
+//
+// No guess is ever made. Singles are applied first, and the rating
+// ends there for the puzzles they finish, the harder techniques only
+// being tried once singles are stuck. Each of those is applied
+// everywhere it is found in one pass before going back to singles.
+// A puzzle singles finish costs as much to rate as to solve
+// with hidden singles, the same deductions being made,
+// and any other costs about one such solve whatever its depth.
+[[nodiscard]] auto rate(const Sudoku& puzzle) noexcept
+  -> difficulty_rating;
+
+// As rate, working on the state of a valid board,
+// which is left holding every deduction made
+//
+// A search carrying on from state, as solver_context::solve does,
+// then skips the propagation the rating has already done,
+// so rating a puzzle before solving it costs little more
+// than the solve alone.
+[[nodiscard]] auto rate(solver_state& state) noexcept
+  -> difficulty_rating;
+
+#endif
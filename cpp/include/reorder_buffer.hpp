@@ -0,0 +1,82 @@
+#ifndef REORDER_BUFFER_HPP
+#define REORDER_BUFFER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// output of one chunk of puzzles handled by a worker thread
+struct chunk_result {
+  std::string output {};
+
+  // puzzles of the chunk which did not come out as asked
+  std::size_t failure_count {};
+};
+
+// Collects chunks as workers finish them, in whatever order that is,
+// and releases them for writing in input order
+class reorder_buffer
+{
+private:
+
+  std::mutex m_mutex {};
+  std::condition_variable m_completed {};
+  std::map<std::size_t, chunk_result> m_pending {};
+  std::size_t m_next_sequence_number {0};
+
+public:
+
+  void complete(const std::size_t sequence_number, chunk_result result)
+  {
+    {
+      const std::lock_guard lock {m_mutex};
+      m_pending.emplace(sequence_number, std::move(result));
+    }
+    m_completed.notify_one();
+  }
+
+  // number of chunks written so far
+  [[nodiscard]] auto written_count() -> std::size_t
+  {
+    const std::lock_guard lock {m_mutex};
+    return m_next_sequence_number;
+  }
+
+  // write every chunk which is next in order,
+  // first waiting for the next one to complete if there are none
+  //
+  // returns the number of failures in the chunks written
+  auto write_ready(std::ostream& out) -> std::size_t
+  {
+    std::vector<chunk_result> ready;
+
+    {
+      std::unique_lock lock {m_mutex};
+      m_completed.wait(lock, [this]() {
+        return m_pending.contains(m_next_sequence_number);
+      });
+
+      for ( auto node {m_pending.extract(m_next_sequence_number)};
+            ! node.empty();
+            node = m_pending.extract(m_next_sequence_number) ) {
+        ready.push_back(std::move(node.mapped()));
+        ++m_next_sequence_number;
+      }
+    }
+
+    std::size_t failure_count {0};
+    for ( const chunk_result& result : ready ) {
+      out << result.output;
+      failure_count += result.failure_count;
+    }
+
+    return failure_count;
+  }
+};
+
+#endif
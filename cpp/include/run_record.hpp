@@ -0,0 +1,60 @@
+#ifndef RUN_RECORD_HPP
+#define RUN_RECORD_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "search_stats.hpp"
+
+// One solve of one puzzle, as written by --format=json or --format=csv
+//
+// Laid out as a single run of hyperfine's exports in written_portion/,
+// data.json and data.csv, so that tools reading those read these too:
+// the command, its time in seconds as mean, median, min, and max,
+// and the strategy and puzzle as parameters "alg" and "puzzle".
+// Times are given to the nanosecond, and only cover the solve itself,
+// not starting the program or reading the input.
+// What hyperfine has no place for follows the columns it writes.
+struct run_record {
+  std::string command {};
+
+  // the strategy's flag without its dashes, as in data.csv
+  std::string alg {};
+
+  // the input file's name without its directory or extension
+  std::string puzzle {};
+  std::string input_path {};
+
+  bool solved {false};
+  std::size_t assignment_count {};
+
+  // as Sudoku::format_line writes it, empty if there was none
+  std::string solution {};
+
+  std::chrono::nanoseconds elapsed {};
+  std::chrono::nanoseconds user_time {};
+  std::chrono::nanoseconds system_time {};
+
+  // empty if none were kept
+  std::optional<search_stats> stats {};
+};
+
+// "evil" for "../inputs/evil.dat"
+[[nodiscard]] auto puzzle_name(std::string_view path) -> std::string;
+
+// as hyperfine --export-json, with results holding record alone
+void write_json(std::ostream& out, const run_record& record);
+
+// the columns of hyperfine --export-csv, then
+// input, time_ns, solved, assignments, solution,
+// and every count of search_stats but its levels
+void write_csv_header(std::ostream& out);
+
+// a row under write_csv_header, with no stats columns left empty
+void write_csv(std::ostream& out, const run_record& record);
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef SEARCH_STATS_HPP
+#define SEARCH_STATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+#include "peer_tables.hpp"
+
+// set to 0 by the SEARCH_STATS build option
+#ifndef SUDOKU_SEARCH_STATS
+#  define SUDOKU_SEARCH_STATS 1
+#endif
+
+// What a search did, to explain why a puzzle took as long as it did
+//
+// Filled in by Sudoku::solve and solver_context::solve when given one,
+// adding to whatever it already holds.
+// Asking for none costs a test of a null pointer per event;
+// building with SEARCH_STATS off compiles every probe away,
+// and the counts stay 0.
+struct search_stats {
+  constexpr static bool enabled {SUDOKU_SEARCH_STATS != 0};
+
+  // every cell of the largest board, and the root
+  constexpr static std::size_t depth_count {board_shape<5>::cell_count
+                                            + 1};
+
+  using duration = std::chrono::nanoseconds;
+
+  struct level {
+    std::size_t nodes {};
+    std::size_t branches {};
+  };
+
+  // every position the search reached, dead ends included
+  std::size_t nodes {};
+
+  // assignments made by choice rather than forced
+  std::size_t branches {};
+
+  // nodes found to leave some cell without a legal digit,
+  // before or after forcing moves, which the search had to back out of
+  std::size_t backtracks {};
+
+  // forced moves, by the rule which forced them
+  std::size_t naked_singles {};
+  std::size_t hidden_singles {};
+
+  std::size_t max_depth {};
+
+  // indexed by the number of branches above a node
+  std::array<level, depth_count> levels {};
+
+  // checking the board and setting up the search
+  duration validate_time {};
+  // forcing moves
+  duration propagate_time {};
+  // choosing cells to branch on and moving between branches
+  duration branch_time {};
+
+  // reading the clock around each phase is the one probe which costs
+  // more than a counter; with this off the times stay 0,
+  // so the counts can be kept for a run which is itself being timed
+  bool time_phases {true};
+
+  [[nodiscard]] auto forced_moves() const noexcept -> std::size_t
+  {
+    return naked_singles + hidden_singles;
+  }
+
+  // one line per count, then a line per depth reached
+  friend auto operator<<(std::ostream& out, const search_stats& rhs)
+    -> std::ostream&;
+};
+
+// stats as a JSON object, with times in nanoseconds
+// and the levels as an array up to max_depth
+void write_json(std::ostream& out, const search_stats& stats);
+
+// runs record on stats, unless they are compiled out or not wanted
+template <typename Recorder>
+constexpr void record_stats(search_stats* const stats,
+                            Recorder&& record) noexcept
+{
+  if constexpr ( search_stats::enabled ) {
+    if ( stats != nullptr ) {
+      record(*stats);
+    }
+  }
+}
+
+// adds the time until it is destroyed to one of the durations of stats,
+// unless they are compiled out, not wanted, or not timing phases
+class stats_timer
+{
+private:
+
+  using clock = std::chrono::steady_clock;
+
+  search_stats::duration* m_total {nullptr};
+  clock::time_point m_start {};
+
+public:
+
+  stats_timer(search_stats* const stats,
+              search_stats::duration search_stats::*const phase) noexcept
+  {
+    if constexpr ( search_stats::enabled ) {
+      if ( stats != nullptr && stats->time_phases ) {
+        m_total = &(stats->*phase);
+        m_start = clock::now();
+      }
+    }
+  }
+
+  stats_timer(const stats_timer&) = delete;
+  stats_timer(stats_timer&&) = delete;
+  auto operator=(const stats_timer&) -> stats_timer& = delete;
+  auto operator=(stats_timer&&) -> stats_timer& = delete;
+
+  ~stats_timer()
+  {
+    if constexpr ( search_stats::enabled ) {
+      if ( m_total != nullptr ) {
+        *m_total += std::chrono::duration_cast<search_stats::duration>(
+          clock::now() - m_start);
+      }
+    }
+  }
+};
+
+#endif
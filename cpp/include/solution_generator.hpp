@@ -0,0 +1,139 @@
+#ifndef SOLUTION_GENERATOR_HPP
+#define SOLUTION_GENERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+// Every solution of a puzzle, produced one at a time as the search finds
+// them
+//
+// Solutions are never stored: each is only valid until the next is
+// asked for, and memory use does not grow with the number produced.
+// Stopping early is a matter of no longer asking.
+//
+// The search works on state held inside the generator,
+// so a generator may be neither copied nor moved.
+template <unsigned BoxSize>
+class basic_solution_generator
+{
+public:
+
+  using board_t = basic_sudoku<BoxSize>;
+
+private:
+
+  // both empty for an invalid board, which has no solutions
+  std::optional<basic_solver_state<BoxSize>> m_state;
+  std::optional<basic_search<BoxSize>> m_search;
+
+  std::size_t m_assignment_count {0};
+  std::size_t m_solution_count {0};
+
+public:
+
+  basic_solution_generator(
+    const board_t& board,
+    basic_optimization_callback_t<BoxSize> optimization_callback,
+    basic_selection_callback_t<BoxSize> selection_callback) noexcept
+  {
+    if ( board.is_valid() ) {
+      m_search.emplace(m_state.emplace(board),
+                       optimization_callback,
+                       selection_callback);
+    }
+  }
+
+  basic_solution_generator(const basic_solution_generator&) = delete;
+  basic_solution_generator(basic_solution_generator&&) = delete;
+  auto operator=(const basic_solution_generator&)
+    -> basic_solution_generator& = delete;
+  auto operator=(basic_solution_generator&&)
+    -> basic_solution_generator& = delete;
+  ~basic_solution_generator() = default;
+
+  // resume the search, returning the next solution,
+  // or nullptr once there are none left
+  [[nodiscard]] auto next() noexcept -> const board_t*
+  {
+    if ( ! m_search.has_value()
+         || m_search->next(m_assignment_count) != search_outcome::solved ) {
+      return nullptr;
+    }
+
+    ++m_solution_count;
+    return &m_state->board();
+  }
+
+  [[nodiscard]] auto assignment_count() const noexcept -> std::size_t
+  {
+    return m_assignment_count;
+  }
+
+  [[nodiscard]] auto solution_count() const noexcept -> std::size_t
+  {
+    return m_solution_count;
+  }
+
+  // single pass, as each increment resumes the search
+  class iterator
+  {
+    basic_solution_generator* m_generator {nullptr};
+    const board_t* m_solution {nullptr};
+
+  public:
+
+    using iterator_concept = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = board_t;
+
+    iterator() = default;
+
+    explicit iterator(basic_solution_generator& generator) noexcept
+        : m_generator {&generator}
+        , m_solution {generator.next()}
+    { }
+
+    [[nodiscard]] auto operator*() const noexcept -> const board_t&
+    {
+      return *m_solution;
+    }
+
+    auto operator++() noexcept -> iterator&
+    {
+      m_solution = m_generator->next();
+      return *this;
+    }
+
+    void operator++(int) noexcept
+    {
+      ++*this;
+    }
+
+    [[nodiscard]] friend auto operator==(const iterator& lhs,
+                                         std::default_sentinel_t) noexcept
+      -> bool
+    {
+      return lhs.m_solution == nullptr;
+    }
+  };
+
+  // starts from the next solution not yet produced,
+  // so a loop which stopped early may be picked up by another
+  [[nodiscard]] auto begin() noexcept -> iterator
+  {
+    return iterator {*this};
+  }
+
+  [[nodiscard]] auto end() const noexcept -> std::default_sentinel_t
+  {
+    return std::default_sentinel;
+  }
+};
+
+using solution_generator = basic_solution_generator<3>;
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef SOLVER_STATE_HPP
+#define SOLVER_STATE_HPP
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "search_stats.hpp"
+#include "sudoku.hpp"
+
+// Search state for the backtracking solver
+//
+// Keeps the remaining domain of every cell up to date as assignments are made:
+// assigning a value strikes it from the domains of the cell's peers
+// (the other cells of its row, column, and box, 20 on a 9x9 board).
+// Every change is recorded on a trail, so backtracking to an earlier
+// mark() only undoes the changes made since, rather than recomputing
+// every domain.
+template <unsigned BoxSize>
+class basic_solver_state
+{
+public:
+
+  using board_t = basic_sudoku<BoxSize>;
+  using mask_t = typename board_t::mask_t;
+  using geometry = typename board_t::geometry;
+  using cell_index_t = typename geometry::cell_index_t;
+
+  // position in the trail, returned by mark() and consumed by undo()
+  using checkpoint = std::size_t;
+
+private:
+
+  struct trail_entry {
+    cell_index_t cell;
+
+    // set for the assignment of `cell` itself,
+    // clear for a removal from the domain of a peer of the assigned cell
+    bool is_assignment;
+
+    // bits removed from the domain of `cell`
+    mask_t removed;
+  };
+
+  board_t m_board;
+
+  // bit n set means (n + 1) may still be assigned to the cell
+  // empty for populated cells
+  std::array<mask_t, geometry::cell_count> m_domains {};
+
+  // every entry takes at least one value out of a domain,
+  // and values only come back as their entries are undone,
+  // so there are never more entries than values in all the domains
+  constexpr static std::size_t trail_capacity {
+    geometry::cell_count * geometry::side};
+
+  // stored inline, so a solve makes no heap allocations
+  std::array<trail_entry, trail_capacity> m_trail {};
+  std::size_t m_trail_size {};
+
+  void push_trail(trail_entry entry) noexcept
+  {
+    assert(m_trail_size < trail_capacity);
+    m_trail.at(m_trail_size) = entry;
+    ++m_trail_size;
+  }
+
+  // number of unpopulated cells left with an empty domain
+  unsigned m_wipeout_count {};
+
+  search_stats* m_stats {nullptr};
+
+  void strike(unsigned cell, mask_t bit) noexcept;
+
+public:
+
+  // board must be valid
+  explicit basic_solver_state(const board_t& board) noexcept;
+
+  [[nodiscard]] auto board() const noexcept -> const board_t&
+  {
+    return m_board;
+  }
+
+  [[nodiscard]] auto domain(index_pair idxs) const noexcept
+    -> std::bitset<geometry::side>
+  {
+    return m_domains.at(idxs.row * geometry::side + idxs.col);
+  }
+
+  [[nodiscard]] auto is_solved() const noexcept -> bool
+  {
+    return m_board.masks().populated_count == geometry::cell_count;
+  }
+
+  // true if some unpopulated cell has no legal assignment left
+  [[nodiscard]] auto has_wipeout() const noexcept -> bool
+  {
+    return m_wipeout_count != 0;
+  }
+
+  // count forced moves into stats from now on, or stop if nullptr
+  void attach_stats(search_stats* const stats) noexcept
+  {
+    m_stats = stats;
+  }
+
+  [[nodiscard]] auto mark() const noexcept -> checkpoint
+  {
+    return m_trail_size;
+  }
+
+  // assignment must be within the current domain of its cell
+  void assign(Assignment assignment) noexcept;
+
+  // strike values from the domain of an unpopulated cell,
+  // as a deduction which places nothing
+  //
+  // returns true if any of them were still in the domain
+  auto eliminate(index_pair idxs, mask_t values) noexcept -> bool;
+
+  // roll back every assignment and elimination made since `point`
+  // was marked
+  void undo(checkpoint point) noexcept;
+
+  // assign every cell whose domain holds a single value,
+  // repeating until none remain or a domain is wiped out
+  //
+  // returns the number of assignments made
+  auto apply_naked_singles() noexcept -> std::size_t;
+
+  // one sweep over every row, column, and box,
+  // assigning each digit which has a single legal cell left in that unit
+  //
+  // returns the number of assignments made
+  auto apply_hidden_singles() noexcept -> std::size_t;
+
+  // alternate naked and hidden singles until neither makes progress,
+  // or a domain is wiped out
+  //
+  // returns the number of assignments made
+  auto apply_singles() noexcept -> std::size_t;
+};
+
+template <unsigned BoxSize>
+using basic_optimization_callback_t =
+  std::add_pointer_t<std::size_t(basic_solver_state<BoxSize>&)>;
+template <unsigned BoxSize>
+using basic_selection_callback_t =
+  std::add_pointer_t<index_pair(const basic_solver_state<BoxSize>&)>;
+
+using optimization_callback_t = basic_optimization_callback_t<3>;
+using selection_callback_t = basic_selection_callback_t<3>;
+
+enum class search_outcome {
+  solved,
+
+  // every branch was tried without success
+  exhausted,
+
+  // a limit was hit before the search could finish
+  interrupted,
+};
+
+struct search_limits {
+  // branches (assignments not forced by the optimization callback)
+  // which may be tried before giving up
+  std::size_t max_branch_count {std::numeric_limits<std::size_t>::max()};
+
+  // polled once per node, if present
+  const std::atomic<bool>* cancelled {nullptr};
+};
+
+// An iterative depth-first search which pauses at each solution
+//
+// Every branch assigns a cell, so there are at most as many levels
+// as cells, all kept in a fixed explicit stack
+// rather than on the call stack.
+// Since the whole search lives in this object,
+// it can be resumed to look for the next solution,
+// or dropped to stop early, with memory use fixed by the board size.
+//
+// The search works on state in place, so state must outlive it.
+template <unsigned BoxSize>
+class basic_search
+{
+public:
+
+  using state_t = basic_solver_state<BoxSize>;
+  using mask_t = typename state_t::mask_t;
+
+private:
+
+  // one level of the search: the cell branched on,
+  // and the values not yet tried for it
+  struct frame {
+    // trail position before the optimization callback ran at this node
+    typename state_t::checkpoint entry_point;
+
+    // trail position after it ran, where each branch is rolled back to
+    typename state_t::checkpoint branch_point;
+
+    index_pair idxs;
+    mask_t untried;
+  };
+
+  state_t& m_state;
+  basic_optimization_callback_t<BoxSize> m_optimization_callback;
+  basic_selection_callback_t<BoxSize> m_selection_callback;
+  search_limits m_limits;
+  search_stats* m_stats;
+
+  std::array<frame, state_t::geometry::cell_count> m_stack;
+  std::size_t m_depth {0};
+  std::size_t m_branch_count {0};
+
+  // whether the next step starts by expanding the current node,
+  // rather than backtracking
+  bool m_expand {true};
+
+  // set while paused at a solution, which is left by rolling back here
+  bool m_at_solution {false};
+  typename state_t::checkpoint m_solution_point {};
+
+  bool m_exhausted {false};
+
+public:
+
+  basic_search(
+    state_t& state,
+    basic_optimization_callback_t<BoxSize> optimization_callback,
+    basic_selection_callback_t<BoxSize> selection_callback,
+    const search_limits& limits = {},
+    search_stats* const stats = nullptr) noexcept
+      : m_state {state}
+      , m_optimization_callback {optimization_callback}
+      , m_selection_callback {selection_callback}
+      , m_limits {limits}
+      , m_stats {stats}
+  {
+    m_state.attach_stats(stats);
+  }
+
+  // Runs until the next solution or the end of the search,
+  // adding every assignment made to assignment_count.
+  // Resuming from a solution first backtracks out of it.
+  //
+  // When solved, state holds the solution.
+  // When exhausted, state is rolled back to how it was found,
+  // and every later call is exhausted straight away.
+  // When interrupted, state is left wherever the search had got to,
+  // and resuming carries on from there.
+  //
+  // Given stats, every call adds to them,
+  // including the forced moves counted by state.
+  auto next(std::size_t& assignment_count) noexcept -> search_outcome;
+
+  // Every branch left open by an interrupted search,
+  // each as the board it would have been taken on
+  // with the branch's value assigned, deepest level first,
+  // which is the order the search would have taken them in.
+  // Together they hold all of the search not yet done,
+  // so it can be carried on elsewhere without repeating any of it.
+  //
+  // State is rolled back to how it was found,
+  // and every later call to next() is exhausted straight away.
+  [[nodiscard]] auto take_open_branches()
+    -> std::vector<basic_sudoku<BoxSize>>;
+};
+
+// The search behind Sudoku::solve
+//
+// When solved, state holds the solution.
+// When exhausted, state is rolled back to how it was found.
+// When interrupted, state is left wherever the search had got to.
+template <unsigned BoxSize>
+auto depth_first_search(
+  basic_solver_state<BoxSize>& state,
+  basic_optimization_callback_t<BoxSize> optimization_callback,
+  basic_selection_callback_t<BoxSize> selection_callback,
+  std::size_t& assignment_count,
+  const search_limits& limits) noexcept -> search_outcome;
+
+// Keeps searching past each solution, backtracking out of it,
+// until solution_limit solutions have been found
+// or every branch has been tried
+//
+// A solution_limit of 0 never stops early.
+// State is rolled back to how it was found.
+//
+// returns the number of solutions found
+template <unsigned BoxSize>
+auto count_solutions(
+  basic_solver_state<BoxSize>& state,
+  basic_optimization_callback_t<BoxSize> optimization_callback,
+  basic_selection_callback_t<BoxSize> selection_callback,
+  std::size_t& assignment_count,
+  std::size_t solution_limit) noexcept -> std::size_t;
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef STRATEGY_HPP
+#define STRATEGY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "exact_cover.hpp"
+#include "search_stats.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+// A way of solving a puzzle, as selected on the command line
+template <unsigned BoxSize>
+struct basic_search_strategy {
+  std::string_view flag;
+
+  // used by basic_sudoku::solve, ignored by the exact cover engine
+  basic_optimization_callback_t<BoxSize> optimization_callback;
+  basic_selection_callback_t<BoxSize> selection_callback;
+
+  // the exact cover engine only solves 9x9 boards
+  bool use_exact_cover;
+};
+
+using search_strategy = basic_search_strategy<3>;
+
+template <unsigned BoxSize>
+constexpr inline std::array basic_search_strategies {
+  basic_search_strategy<BoxSize> {"--simple",
+                                  &null_optimization,
+                                  &first_unassigned_selection,
+                                  false},
+  basic_search_strategy<BoxSize> {"--smart",
+                                  &trivial_move_optimization,
+                                  &first_unassigned_selection,
+                                  false},
+  basic_search_strategy<BoxSize> {"--mrv",
+                                  &trivial_move_optimization,
+                                  &minimum_remaining_values_selection,
+                                  false},
+  basic_search_strategy<BoxSize> {"--hidden",
+                                  &hidden_single_optimization,
+                                  &minimum_remaining_values_selection,
+                                  false},
+  basic_search_strategy<BoxSize> {"--dlx", nullptr, nullptr, true},
+};
+
+constexpr inline const auto& search_strategies {
+  basic_search_strategies<3>};
+
+// nullptr if flag names no strategy
+template <unsigned BoxSize = 3>
+[[nodiscard]] constexpr auto find_strategy(
+  const std::string_view flag) noexcept
+  -> const basic_search_strategy<BoxSize>*
+{
+  const auto& strategies {basic_search_strategies<BoxSize>};
+  const auto* const found {std::ranges::find(
+    strategies, flag, &basic_search_strategy<BoxSize>::flag)};
+  return found == strategies.end() ? nullptr : found;
+}
+
+// Everything needed to solve puzzles with any strategy
+//
+// The exact cover engine's node pool is large,
+// so it is kept here to be reused across puzzles
+class solver_context
+{
+private:
+
+  exact_cover_solver m_exact_cover {};
+
+public:
+
+  // same contract as Sudoku::solve
+  [[nodiscard]] auto solve(Sudoku& sudoku,
+                           const search_strategy& strategy,
+                           search_stats* const stats = nullptr) noexcept
+    -> std::pair<std::size_t, bool>
+  {
+    if ( strategy.use_exact_cover ) {
+      return m_exact_cover.solve(sudoku, stats);
+    }
+
+    return sudoku.solve(strategy.optimization_callback,
+                        strategy.selection_callback,
+                        stats);
+  }
+
+  // As solve, but carrying on from the domains of state,
+  // which earlier deductions, such as rate's, have already narrowed
+  //
+  // sudoku is given the solution if one is found.
+  // The exact cover engine starts from the cells state has filled,
+  // but cannot use the candidates it has ruled out.
+  [[nodiscard]] auto solve(solver_state& state,
+                           const search_strategy& strategy,
+                           Sudoku& sudoku) noexcept
+    -> std::pair<std::size_t, bool>
+  {
+    sudoku = state.board();
+
+    if ( strategy.use_exact_cover ) {
+      return m_exact_cover.solve(sudoku);
+    }
+
+    std::size_t assignment_count {};
+
+    if ( depth_first_search(state,
+                            strategy.optimization_callback,
+                            strategy.selection_callback,
+                            assignment_count,
+                            {})
+         != search_outcome::solved ) {
+      return {assignment_count, false};
+    }
+
+    sudoku = state.board();
+    return {assignment_count, true};
+  }
+};
+
+#endif
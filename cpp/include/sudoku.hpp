@@ -1,13 +1,14 @@
 #ifndef SUDOKU_HPP
 #define SUDOKU_HPP
 
-#include <algorithm>
 #include <array>
 #include <bitset>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <iterator>
-#include <string>
+#include <optional>
+#include <string_view>
 #include <type_traits>
 
 #include <supl/metaprogramming.hpp>
@@ -15,6 +16,8 @@
 
 #include <mdspan/mdspan.hpp>
 
+#include "peer_tables.hpp"
+
 struct index_pair {
   unsigned row;
   unsigned col;
@@ -52,6 +55,11 @@ struct Assignment {
   }
 };
 
+template <unsigned BoxSize>
+class basic_solver_state;
+
+struct search_stats;
+
 struct variable_domain {
   index_pair idxs {};
   std::bitset<9> legal_assignments {};
@@ -85,37 +93,149 @@ struct variable_domain {
   }
 };
 
-class Sudoku
+// A board of BoxSize x BoxSize boxes, each of BoxSize x BoxSize cells
+//
+// The board size is a compile-time constant,
+// so every table, mask, and loop bound is as well.
+// 4x4, 9x9, 16x16, and 25x25 boards are supported,
+// Sudoku being the standard 9x9 board.
+template <unsigned BoxSize>
+class basic_sudoku
 {
 public:
+
+  using geometry = board_geometry<BoxSize>;
+
+  // cells per row, column, and box, as well as the number of digits
+  constexpr static unsigned side {geometry::side};
+  constexpr static unsigned cell_count {geometry::cell_count};
+
+  // wide enough for a bit per digit
+  using mask_t = std::
+    conditional_t<(side <= 16), std::uint16_t, std::uint32_t>;
+
+  // side-bit occupancy masks for each row, column, and box
+  // bit n is set when the digit (n + 1) is present in that unit
+  //
+  // a cell's legal assignments are the complement of
+  // (row mask | column mask | box mask)
+  struct occupancy_masks {
+    std::array<mask_t, side> rows {};
+    std::array<mask_t, side> cols {};
+    std::array<mask_t, side> boxes {};
+
+    // number of cells holding a digit
+    unsigned populated_count {};
+
+    // set if any digit appears twice within a single unit
+    bool has_conflict {};
+
+    friend inline auto operator==(const occupancy_masks&,
+                                  const occupancy_masks&) noexcept
+      -> bool = default;
+  };
+
 private:
 
-  std::array<char, 81> m_data {};
+  std::array<char, cell_count> m_data {};
+
+  // derived from m_data, and always kept in step with it:
+  // built with the board, and updated by try_assign, unassign,
+  // and set_cell, the only members which write a cell
+  //
+  // so no const member writes to the board,
+  // and a const board may be read from several threads at once
+  occupancy_masks m_masks {};
+
+  void rebuild_masks() noexcept;
 
 public:
 
-  constexpr static inline std::array
-    charset {'1', '2', '3', '4', '5', '6', '7', '8', '9', '_'};
+  // the digits 1 through 9 are written as such,
+  // the digits past 9 as letters from 'A', so 16 is 'G' and 25 is 'P'
+  // '_' marks an empty cell
+  constexpr static inline std::array<char, side + 1> charset {[]() {
+    std::array<char, side + 1> symbols {};
+    for ( unsigned digit {0}; digit < side; ++digit ) {
+      symbols.at(digit) = static_cast<char>(
+        digit < 9 ? '1' + digit : 'A' + (digit - 9));
+    }
+    symbols.at(side) = '_';
+    return symbols;
+  }()};  // Immediately Invoked Lambda Expression
+
+  // bit of the digit written as symbol, which must be in charset
+  [[nodiscard]] constexpr static auto
+  digit_index(const char symbol) noexcept
+    -> unsigned
+  {
+    assert(symbol != '_');
 
-  // default constructor leaves board in invalid state
-  Sudoku() = default;
+    if constexpr ( side <= 9 ) {
+      return static_cast<unsigned>(symbol - '1');
+    } else {
+      return symbol <= '9' ? static_cast<unsigned>(symbol - '1')
+                           : static_cast<unsigned>(symbol - 'A') + 9;
+    }
+  }
 
-  explicit Sudoku(const std::array<char, 81>& arg)
-      : m_data {arg}
-  { }
+  // inverse of digit_index
+  [[nodiscard]] constexpr static auto
+  digit_symbol(const unsigned index) noexcept
+    -> char
+  {
+    assert(index < side);
 
-  Sudoku(const Sudoku&) noexcept = default;
-  Sudoku(Sudoku&&) noexcept = default;
-  auto operator=(const Sudoku&) noexcept -> Sudoku& = default;
-  auto operator=(Sudoku&&) noexcept -> Sudoku& = default;
-  ~Sudoku() = default;
+    if constexpr ( side <= 9 ) {
+      return static_cast<char>('1' + index);
+    } else {
+      return charset[index];
+    }
+  }
 
-  [[nodiscard]] auto data() const noexcept -> const std::array<char, 81>&
+  [[nodiscard]] constexpr static auto
+  is_digit_symbol(const char symbol) noexcept
+    -> bool
   {
-    return m_data;
+    return (symbol >= '1' && symbol <= '9' && digit_index(symbol) < side)
+        || (symbol >= 'A' && symbol <= 'Z' && digit_index(symbol) < side);
   }
 
-  [[nodiscard]] auto data() noexcept -> std::array<char, 81>&
+  // the ways an empty cell may be written in input
+  [[nodiscard]] constexpr static auto
+  is_blank_symbol(const char symbol) noexcept
+    -> bool
+  {
+    return symbol == '_' || symbol == '.' || symbol == '0';
+  }
+
+  // characters allowed between cells in input and otherwise ignored:
+  // whitespace, and the lines drawn between boxes
+  [[nodiscard]] constexpr static auto
+  is_separator_symbol(const char symbol) noexcept
+    -> bool
+  {
+    return symbol == ' ' || (symbol >= '\t' && symbol <= '\r')
+        || symbol == '|' || symbol == '-' || symbol == '+';
+  }
+
+  // default constructor leaves board in invalid state
+  basic_sudoku() = default;
+
+  explicit basic_sudoku(const std::array<char, cell_count>& arg)
+      : m_data {arg}
+  {
+    this->rebuild_masks();
+  }
+
+  basic_sudoku(const basic_sudoku&) noexcept = default;
+  basic_sudoku(basic_sudoku&&) noexcept = default;
+  auto operator=(const basic_sudoku&) noexcept -> basic_sudoku& = default;
+  auto operator=(basic_sudoku&&) noexcept -> basic_sudoku& = default;
+  ~basic_sudoku() = default;
+
+  [[nodiscard]] auto data() const noexcept
+    -> const std::array<char, cell_count>&
   {
     return m_data;
   }
@@ -133,18 +253,36 @@ public:
   template <bool is_const>
   using mdview_t =
     Kokkos::mdspan<supl::apply_if_t<is_const, std::add_const, char>,
-                   Kokkos::extents<unsigned short, 9, 9>>;
+                   Kokkos::extents<unsigned short, side, side>>;
 
-  [[nodiscard]] auto mdview() noexcept -> mdview_t<false>
+  // read only, as writes go through set_cell to keep the masks in step
+  [[nodiscard]] auto mdview() const noexcept -> mdview_t<true>
   {
-    return mdview_t<false> {m_data.data()};
+    return mdview_t<true> {m_data.data()};
   }
 
-  [[nodiscard]] auto mdview() const noexcept -> mdview_t<true>
+  // index of the box containing the cell, counted row-major
+  [[nodiscard]] constexpr static auto box_index(index_pair idxs) noexcept
+    -> unsigned
   {
-    return mdview_t<true> {m_data.data()};
+    return geometry::positions.boxes.at(idxs.row * side + idxs.col);
   }
 
+  [[nodiscard]] auto masks() const noexcept -> const occupancy_masks&
+  {
+    return m_masks;
+  }
+
+  // legal assignments of a single cell, bit n representing the digit (n + 1)
+  // always empty for a populated cell
+  [[nodiscard]] auto candidates(index_pair idxs) const noexcept
+    -> std::bitset<side>;
+
+  // candidates() of every cell at once, in row-major order
+  using candidate_masks = std::array<mask_t, cell_count>;
+
+  [[nodiscard]] auto all_candidates() const noexcept -> candidate_masks;
+
   [[nodiscard]] auto is_solved() const noexcept -> bool;
 
   [[nodiscard]] auto is_valid() const noexcept -> bool;
@@ -162,11 +300,18 @@ public:
   [[nodiscard]] auto try_assign(index_pair idxs, char value) noexcept
     -> bool
   {
-    if ( this->is_legal_assignment(idxs, value) ) {
-      this->mdview()(idxs.row, idxs.col) = value;
-      return true;
+    if ( ! this->is_legal_assignment(idxs, value) ) {
+      return false;
     }
-    return false;
+
+    const auto bit {static_cast<mask_t>(1U << digit_index(value))};
+    m_masks.rows.at(idxs.row) |= bit;
+    m_masks.cols.at(idxs.col) |= bit;
+    m_masks.boxes.at(box_index(idxs)) |= bit;
+    ++m_masks.populated_count;
+
+    m_data.at(idxs.row * side + idxs.col) = value;
+    return true;
   }
 
   [[nodiscard]] auto try_assign(Assignment assignment) noexcept -> bool
@@ -174,11 +319,67 @@ public:
     return this->try_assign(assignment.idxs, assignment.value);
   }
 
+  // clear a populated cell, the inverse of a successful try_assign
+  void unassign(index_pair idxs) noexcept
+  {
+    char& cell {m_data.at(idxs.row * side + idxs.col)};
+
+    assert(is_digit_symbol(cell));
+
+    // with a duplicate present, the digit may still occur elsewhere
+    // in the unit, so fall back to a rebuild
+    if ( m_masks.has_conflict ) {
+      cell = '_';
+      this->rebuild_masks();
+      return;
+    }
+
+    const auto bit {static_cast<mask_t>(~(1U << digit_index(cell)))};
+    m_masks.rows.at(idxs.row) &= bit;
+    m_masks.cols.at(idxs.col) &= bit;
+    m_masks.boxes.at(box_index(idxs)) &= bit;
+    --m_masks.populated_count;
+
+    cell = '_';
+  }
+
+  // write a digit or '_' to a cell, whether or not it breaks a rule,
+  // for building boards cell by cell, broken ones included
+  void set_cell(index_pair idxs, const char symbol) noexcept
+  {
+    assert(is_digit_symbol(symbol) || symbol == '_');
+
+    if ( is_digit_symbol(m_data.at(idxs.row * side + idxs.col)) ) {
+      this->unassign(idxs);
+    }
+
+    if ( symbol == '_' ) {
+      m_data.at(idxs.row * side + idxs.col) = '_';
+      return;
+    }
+
+    const auto bit {static_cast<mask_t>(1U << digit_index(symbol))};
+    mask_t& row_mask {m_masks.rows.at(idxs.row)};
+    mask_t& col_mask {m_masks.cols.at(idxs.col)};
+    mask_t& box_mask {m_masks.boxes.at(box_index(idxs))};
+
+    if ( ((row_mask | col_mask | box_mask) & bit) != 0 ) {
+      m_masks.has_conflict = true;
+    }
+
+    row_mask |= bit;
+    col_mask |= bit;
+    box_mask |= bit;
+    ++m_masks.populated_count;
+
+    m_data.at(idxs.row * side + idxs.col) = symbol;
+  }
+
   [[nodiscard]] auto assign_copy(Assignment assignment) const noexcept
-    -> Sudoku
+    -> basic_sudoku
   {
     assert(this->is_legal_assignment(assignment));
-    Sudoku copy {*this};
+    basic_sudoku copy {*this};
     [[maybe_unused]] const bool success {copy.try_assign(assignment)};
     assert(success);
     return copy;
@@ -191,56 +392,162 @@ public:
   // returns true if move was applied, returns false if no trivial move exists
   [[nodiscard]] auto apply_trivial_move() noexcept -> bool;
 
-  [[nodiscard]] auto solve(std::add_pointer_t<std::size_t(Sudoku&)>
-                             optimization_callback) noexcept
+  // returns the assignment count and whether a solution was found,
+  // which is then held here
+  //
+  // the search is counted into stats if given (see search_stats)
+  [[nodiscard]] auto solve(
+    std::add_pointer_t<std::size_t(basic_solver_state<BoxSize>&)>
+      optimization_callback,
+    std::add_pointer_t<index_pair(const basic_solver_state<BoxSize>&)>
+      selection_callback,
+    search_stats* stats = nullptr) noexcept
     -> std::pair<std::size_t, bool>;
 
+  // search past the first solution, stopping once solution_limit
+  // solutions have been found (0 for no limit)
+  // a limit of 2 is enough to tell whether the solution is unique
+  //
+  // returns the assignment count and the number of solutions found
+  [[nodiscard]] auto count_solutions(
+    std::add_pointer_t<std::size_t(basic_solver_state<BoxSize>&)>
+      optimization_callback,
+    std::add_pointer_t<index_pair(const basic_solver_state<BoxSize>&)>
+      selection_callback,
+    std::size_t solution_limit) const noexcept
+    -> std::pair<std::size_t, std::size_t>;
+
   [[nodiscard]] auto query_domains() const noexcept
-    -> std::array<variable_domain, 81>;
+    -> std::array<variable_domain, 81>
+    requires (BoxSize == 3);
 
   [[nodiscard]] auto has_legal_assignments() const noexcept -> bool;
 
-  friend auto operator<=>(const Sudoku& lhs,
-                          const Sudoku& rhs) noexcept = default;
+  // masks are derived from m_data, so only m_data takes part in comparison
+  friend inline auto operator<=>(const basic_sudoku& lhs,
+                                 const basic_sudoku& rhs) noexcept
+  {
+    return lhs.m_data <=> rhs.m_data;
+  }
 
-  friend inline auto operator>>(std::istream& in, Sudoku& rhs) noexcept
+  friend inline auto operator==(const basic_sudoku& lhs,
+                                const basic_sudoku& rhs) noexcept -> bool
+  {
+    return lhs.m_data == rhs.m_data;
+  }
+
+  // parse the single-line format used for puzzle corpora:
+  // every cell in row-major order,
+  // with '.', '0', or '_' for an empty cell
+  // separators (see is_separator_symbol), such as a trailing '\r',
+  // are ignored
+  //
+  // nullopt if the line is malformed, parse_board telling why
+  [[nodiscard]] static auto from_line(std::string_view line) noexcept
+    -> std::optional<basic_sudoku>;
+
+  // read cells as from_line does, stopping after the last one
+  //
+  // failbit is set, and rhs left alone, if a character is neither a cell
+  // nor a separator, which is left unread, or if the input runs out first
+  friend inline auto operator>>(std::istream& in, basic_sudoku& rhs)
     -> std::istream&
   {
-    std::copy_n(std::istream_iterator<char> {in}, 81, rhs.m_data.begin());
+    using traits = std::istream::traits_type;
+
+    const std::istream::sentry sentry {in, true};
+    if ( ! sentry ) {
+      return in;
+    }
+
+    std::array<char, cell_count> cells {};
+    std::size_t count {0};
+    std::streambuf* const buffer {in.rdbuf()};
+
+    while ( count < cell_count ) {
+      const traits::int_type next {buffer->sgetc()};
+
+      if ( traits::eq_int_type(next, traits::eof()) ) {
+        in.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+        return in;
+      }
+
+      const char symbol {traits::to_char_type(next)};
+
+      if ( is_digit_symbol(symbol) ) {
+        cells.at(count++) = symbol;
+      } else if ( is_blank_symbol(symbol) ) {
+        cells.at(count++) = '_';
+      } else if ( ! is_separator_symbol(symbol) ) {
+        in.setstate(std::ios_base::failbit);
+        return in;
+      }
+
+      buffer->sbumpc();
+    }
+
+    rhs = basic_sudoku {cells};
     return in;
   }
 
+  // width of a row as format_grid writes it, not counting its newline
+  constexpr static std::size_t grid_width {2 * side + 2 * BoxSize - 3};
+
+  // bytes format_grid writes:
+  // a leading newline, then every row and divider with its own
+  constexpr static std::size_t grid_size {
+    1 + (side + BoxSize - 1) * (grid_width + 1)};
+
+  // write the board as operator<< prints it into out,
+  // which must have room for grid_size bytes,
+  // returning one past the last byte written
+  //
+  // everything but the cells is copied from a layout built at compile
+  // time, so this is one copy and one store per cell, with no allocation
+  auto format_grid(char* out) const noexcept -> char*;
+
+  // write the cells in the single-line format from_line reads,
+  // without a newline, into out, which must have room for cell_count
+  // bytes, returning one past the last byte written
+  auto format_line(char* out) const noexcept -> char*;
+
+  // rows of space separated cells, boxes divided by lines
+  //
+  // X X X | X X X | X X X
+  // ------+-------+------
   friend inline auto operator<<(std::ostream& out,
-                                const Sudoku& rhs) noexcept
+                                const basic_sudoku& rhs) noexcept
     -> std::ostream&
   {
+    std::array<char, grid_size> text;
+    rhs.format_grid(text.data());
 
-    std::string output_buffer {
-      R"(
-X X X | X X X | X X X
-X X X | X X X | X X X
-X X X | X X X | X X X
-------+-------+------
-X X X | X X X | X X X
-X X X | X X X | X X X
-X X X | X X X | X X X
-------+-------+------
-X X X | X X X | X X X
-X X X | X X X | X X X
-X X X | X X X | X X X
-)"};
-
-    for ( const char elem : rhs.m_data ) {
-      output_buffer.at(output_buffer.find('X')) = elem;
-    }
-
-    return out << output_buffer;
+    return out.write(text.data(), grid_size);
   }
 };
 
+using Sudoku = basic_sudoku<3>;
+using solver_state = basic_solver_state<3>;
+
 // forward declarations for optimization callbacks
 
-auto null_optimization(Sudoku&) -> std::size_t;
-auto trivial_move_optimization(Sudoku&) -> std::size_t;
+template <unsigned BoxSize>
+auto null_optimization(basic_solver_state<BoxSize>&) -> std::size_t;
+template <unsigned BoxSize>
+auto trivial_move_optimization(basic_solver_state<BoxSize>&)
+  -> std::size_t;
+template <unsigned BoxSize>
+auto hidden_single_optimization(basic_solver_state<BoxSize>&)
+  -> std::size_t;
+
+// forward declarations for variable selection callbacks
+// each picks the unassigned cell to branch on next
+
+template <unsigned BoxSize>
+auto first_unassigned_selection(const basic_solver_state<BoxSize>&)
+  -> index_pair;
+template <unsigned BoxSize>
+auto minimum_remaining_values_selection(
+  const basic_solver_state<BoxSize>&) -> index_pair;
 
 #endif
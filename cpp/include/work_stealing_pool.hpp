@@ -0,0 +1,186 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixed-size pool of worker threads, each with its own task deque
+//
+// Submitted tasks are dealt round-robin onto the workers' deques.
+// A worker takes tasks from the front of its own deque,
+// and once that is empty, steals from the back of the others',
+// so no core sits idle while work remains anywhere in the pool.
+//
+// Each worker default-constructs a WorkerState on its own stack,
+// which is passed to the handler along with every task that worker runs.
+// Useful for per-thread scratch space such as a solver_context.
+template <typename Task, typename WorkerState>
+class work_stealing_pool
+{
+public:
+
+  using handler_t = std::function<void(WorkerState&, Task&)>;
+
+private:
+
+  struct task_deque {
+    std::mutex mutex {};
+    std::deque<Task> tasks {};
+  };
+
+  handler_t m_handler;
+
+  // unique_ptr as std::mutex is not movable
+  std::vector<std::unique_ptr<task_deque>> m_deques {};
+
+  // tasks submitted but not yet taken by a worker
+  std::atomic<std::size_t> m_queued_count {0};
+
+  std::mutex m_wake_mutex {};
+  std::condition_variable m_wake {};
+  bool m_stopping {false};
+
+  std::size_t m_next_deque {0};
+
+  std::vector<std::thread> m_threads {};
+
+  auto try_pop_front(const std::size_t idx) -> std::optional<Task>
+  {
+    task_deque& deque {*m_deques.at(idx)};
+    const std::lock_guard lock {deque.mutex};
+    if ( deque.tasks.empty() ) {
+      return std::nullopt;
+    }
+    Task task {std::move(deque.tasks.front())};
+    deque.tasks.pop_front();
+    return task;
+  }
+
+  auto try_steal_back(const std::size_t idx) -> std::optional<Task>
+  {
+    task_deque& deque {*m_deques.at(idx)};
+    const std::lock_guard lock {deque.mutex};
+    if ( deque.tasks.empty() ) {
+      return std::nullopt;
+    }
+    Task task {std::move(deque.tasks.back())};
+    deque.tasks.pop_back();
+    return task;
+  }
+
+  auto try_take(const std::size_t own_idx) -> std::optional<Task>
+  {
+    if ( auto task {this->try_pop_front(own_idx)}; task.has_value() ) {
+      return task;
+    }
+
+    for ( std::size_t offset {1}; offset < m_deques.size(); ++offset ) {
+      const std::size_t victim {(own_idx + offset) % m_deques.size()};
+      if ( auto task {this->try_steal_back(victim)}; task.has_value() ) {
+        return task;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  void worker_loop(const std::size_t own_idx)
+  {
+    WorkerState state {};
+
+    while ( true ) {
+      if ( auto task {this->try_take(own_idx)}; task.has_value() ) {
+        m_queued_count.fetch_sub(1, std::memory_order_relaxed);
+        m_handler(state, *task);
+        continue;
+      }
+
+      std::unique_lock lock {m_wake_mutex};
+      m_wake.wait(lock, [this]() {
+        return m_stopping
+            || m_queued_count.load(std::memory_order_relaxed) != 0;
+      });
+
+      if ( m_stopping
+           && m_queued_count.load(std::memory_order_relaxed) == 0 ) {
+        return;
+      }
+    }
+  }
+
+public:
+
+  work_stealing_pool(const std::size_t thread_count, handler_t handler)
+      : m_handler {std::move(handler)}
+  {
+    const std::size_t count {thread_count == 0 ? 1 : thread_count};
+
+    m_deques.reserve(count);
+    for ( std::size_t i {0}; i < count; ++i ) {
+      m_deques.push_back(std::make_unique<task_deque>());
+    }
+
+    m_threads.reserve(count);
+    for ( std::size_t i {0}; i < count; ++i ) {
+      m_threads.emplace_back([this, i]() {
+        this->worker_loop(i);
+      });
+    }
+  }
+
+  work_stealing_pool(const work_stealing_pool&) = delete;
+  work_stealing_pool(work_stealing_pool&&) = delete;
+  auto operator=(const work_stealing_pool&) -> work_stealing_pool& = delete;
+  auto operator=(work_stealing_pool&&) -> work_stealing_pool& = delete;
+
+  // runs every task already submitted before returning
+  ~work_stealing_pool()
+  {
+    {
+      const std::lock_guard lock {m_wake_mutex};
+      m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for ( std::thread& thread : m_threads ) {
+      thread.join();
+    }
+  }
+
+  [[nodiscard]] auto thread_count() const noexcept -> std::size_t
+  {
+    return m_threads.size();
+  }
+
+  // must not be called concurrently with itself
+  void submit(Task task)
+  {
+    {
+      // counted before the task is visible, so a worker never takes
+      // a task that has not been counted yet
+      // under the lock so a worker about to wait cannot miss the update
+      const std::lock_guard lock {m_wake_mutex};
+      m_queued_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+      task_deque& deque {*m_deques.at(m_next_deque)};
+      const std::lock_guard lock {deque.mutex};
+      deque.tasks.push_back(std::move(task));
+    }
+    m_next_deque = (m_next_deque + 1) % m_deques.size();
+
+    m_wake.notify_one();
+  }
+};
+
+#endif
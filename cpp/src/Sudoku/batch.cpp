@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "batch.hpp"
+#include "corpus_reader.hpp"
+#include "rater.hpp"
+#include "reorder_buffer.hpp"
+#include "solver_state.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+#include "work_stealing_pool.hpp"
+
+// append the output line for one puzzle,
+// returning whether it was solved
+static auto solve_line(solver_context& context,
+                       const search_strategy& strategy,
+                       const std::string_view line,
+                       std::string& output) -> bool
+{
+  auto puzzle {Sudoku::from_line(line)};
+  const bool solved {puzzle.has_value()
+                     && context.solve(*puzzle, strategy).second};
+
+  if ( solved ) {
+    const std::size_t start {output.size()};
+    output.resize(start + Sudoku::cell_count);
+    puzzle->format_line(output.data() + start);
+  } else {
+    output.append(batch_failure_prefix);
+    output.append(line);
+  }
+
+  output.push_back('\n');
+  return solved;
+}
+
+namespace {
+// lines read at a time when working alone
+constexpr std::size_t serial_block_size {4096};
+}  // namespace
+
+// Reads puzzles from in, one per line, handing each one to handle_line,
+// and writes whatever it appends to its output argument
+//
+// handle_line takes (solver_context&, std::string_view line, std::string&)
+// and returns false if the puzzle counts as a failure
+template <typename LineHandler>
+static auto process_batch(corpus_reader& in,
+                          std::ostream& out,
+                          LineHandler&& handle_line) -> batch_report
+{
+  batch_report report {};
+  solver_context context {};
+
+  const auto start_time {std::chrono::steady_clock::now()};
+
+  // a block's output is written all at once
+  std::string output;
+  for ( corpus_block block {in.next_block(serial_block_size)};
+        ! block.text.empty();
+        block = in.next_block(serial_block_size) ) {
+    report.puzzle_count += block.line_count;
+
+    output.clear();
+    block.for_each_line([&](const std::string_view line) {
+      if ( ! handle_line(context, line, output) ) {
+        ++report.failure_count;
+      }
+    });
+
+    out.write(output.data(), static_cast<std::streamsize>(output.size()));
+  }
+
+  out.flush();
+
+  report.elapsed = std::chrono::steady_clock::now() - start_time;
+  return report;
+}
+
+namespace {
+// consecutive puzzles handed to a worker as one task,
+// to amortize synchronization over many cheap solves
+constexpr std::size_t chunk_size {128};
+
+struct batch_chunk {
+  std::size_t sequence_number {};
+  corpus_block lines {};
+};
+}  // namespace
+
+// As process_batch, spread over a pool of worker threads
+//
+// handle_line is called concurrently, each worker passing its own context
+template <typename LineHandler>
+static auto process_batch_parallel(corpus_reader& in,
+                                   std::ostream& out,
+                                   LineHandler&& handle_line,
+                                   const std::size_t thread_count)
+  -> batch_report
+{
+  batch_report report {};
+
+  const auto start_time {std::chrono::steady_clock::now()};
+
+  reorder_buffer buffer {};
+
+  work_stealing_pool<batch_chunk, solver_context> pool {
+    thread_count == 0
+      ? std::max(std::size_t {1},
+                 std::size_t {std::thread::hardware_concurrency()})
+      : thread_count,
+    [&buffer, &handle_line](solver_context& context, batch_chunk& chunk) {
+      chunk_result result {};
+      result.output.reserve(chunk.lines.line_count * 82);
+
+      chunk.lines.for_each_line([&](const std::string_view line) {
+        if ( ! handle_line(context, line, result.output) ) {
+          ++result.failure_count;
+        }
+      });
+
+      buffer.complete(chunk.sequence_number, std::move(result));
+    }};
+
+  report.thread_count = pool.thread_count();
+
+  // bounds how far reading may run ahead of writing,
+  // and so the memory held by the reorder buffer
+  const std::size_t max_chunks_in_flight {pool.thread_count() * 4};
+
+  std::size_t submitted_count {0};
+  for ( corpus_block lines {in.next_block(chunk_size)};
+        ! lines.text.empty();
+        lines = in.next_block(chunk_size) ) {
+    while ( submitted_count - buffer.written_count()
+            >= max_chunks_in_flight ) {
+      report.failure_count += buffer.write_ready(out);
+    }
+
+    report.puzzle_count += lines.line_count;
+    pool.submit({submitted_count, std::move(lines)});
+    ++submitted_count;
+  }
+
+  while ( buffer.written_count() < submitted_count ) {
+    report.failure_count += buffer.write_ready(out);
+  }
+
+  out.flush();
+
+  report.elapsed = std::chrono::steady_clock::now() - start_time;
+  return report;
+}
+
+auto solve_batch(corpus_reader& in,
+                 std::ostream& out,
+                 const search_strategy& strategy) -> batch_report
+{
+  return process_batch(
+    in,
+    out,
+    [&strategy](solver_context& context,
+                const std::string_view line,
+                std::string& output) {
+      return solve_line(context, strategy, line, output);
+    });
+}
+
+auto solve_batch_parallel(corpus_reader& in,
+                          std::ostream& out,
+                          const search_strategy& strategy,
+                          const std::size_t thread_count) -> batch_report
+{
+  return process_batch_parallel(
+    in,
+    out,
+    [&strategy](solver_context& context,
+                const std::string_view line,
+                std::string& output) {
+      return solve_line(context, strategy, line, output);
+    },
+    thread_count);
+}
+
+// append the line, then its rating, then its solution if strategy
+// is given, returning whether it was consistent and solved
+static auto rate_line(solver_context& context,
+                      const search_strategy* const strategy,
+                      const std::string_view line,
+                      std::string& output) -> bool
+{
+  const auto puzzle {Sudoku::from_line(line)};
+  difficulty_rating rating {.consistent = false};
+  bool solved {false};
+  Sudoku solution {};
+
+  if ( puzzle.has_value() && puzzle->is_valid() ) {
+    solver_state state {*puzzle};
+    rating = rate(state);
+
+    if ( strategy != nullptr && rating.consistent ) {
+      solved = context.solve(state, *strategy, solution).second;
+    }
+  }
+
+  output.append(line);
+  output.push_back('\t');
+  output.append(difficulty_tier(rating));
+  output.push_back('\t');
+  output.append(rating.hardest.has_value()
+                  ? technique_name(*rating.hardest)
+                  : std::string_view {"none"});
+  output.push_back('\t');
+
+  std::array<char, 32> number {};
+  output.append(number.data(),
+                std::to_chars(number.data(),
+                              number.data() + number.size(),
+                              rating.cells_left)
+                  .ptr);
+  output.push_back('\t');
+  output.append(number.data(),
+                std::to_chars(number.data(),
+                              number.data() + number.size(),
+                              rating.search_space_bits,
+                              std::chars_format::fixed,
+                              1)
+                  .ptr);
+
+  if ( strategy == nullptr ) {
+    output.push_back('\n');
+    return rating.consistent;
+  }
+
+  output.push_back('\t');
+
+  if ( solved ) {
+    const std::size_t start {output.size()};
+    output.resize(start + Sudoku::cell_count);
+    solution.format_line(output.data() + start);
+  } else {
+    output.append("none");
+  }
+
+  output.push_back('\n');
+  return solved;
+}
+
+auto rate_batch(corpus_reader& in,
+                std::ostream& out,
+                const std::size_t thread_count,
+                const search_strategy* const strategy) -> batch_report
+{
+  const auto handle_line {[strategy](solver_context& context,
+                                     const std::string_view line,
+                                     std::string& output) {
+    return rate_line(context, strategy, line, output);
+  }};
+
+  return thread_count == 1
+         ? process_batch(in, out, handle_line)
+         : process_batch_parallel(in, out, handle_line, thread_count);
+}
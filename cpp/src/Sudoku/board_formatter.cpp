@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "sudoku.hpp"
+
+namespace {
+// the text of an empty board as format_grid writes it,
+// and where each cell goes within it
+template <unsigned BoxSize>
+struct grid_layout {
+  using board_t = basic_sudoku<BoxSize>;
+
+  std::array<char, board_t::grid_size> text {};
+  std::array<std::uint16_t, board_t::cell_count> cell_offsets {};
+};
+
+template <unsigned BoxSize>
+constexpr grid_layout<BoxSize> layout {[]() {
+  using board_t = basic_sudoku<BoxSize>;
+  constexpr unsigned side {board_t::side};
+
+  grid_layout<BoxSize> result {};
+  std::size_t position {0};
+
+  const auto put {[&result, &position](const char symbol) {
+    result.text.at(position++) = symbol;
+  }};
+
+  put('\n');
+
+  for ( unsigned row {0}; row < side; ++row ) {
+    // a row's divider is the row itself,
+    // with '+' where it crosses a box line and '-' everywhere else
+    if ( row != 0 && row % BoxSize == 0 ) {
+      for ( unsigned col {0}; col < side; ++col ) {
+        if ( col != 0 ) {
+          if ( col % BoxSize == 0 ) {
+            put('-');
+            put('+');
+          }
+          put('-');
+        }
+        put('-');
+      }
+      put('\n');
+    }
+
+    for ( unsigned col {0}; col < side; ++col ) {
+      if ( col != 0 ) {
+        if ( col % BoxSize == 0 ) {
+          put(' ');
+          put('|');
+        }
+        put(' ');
+      }
+
+      result.cell_offsets.at(row * side + col) =
+        static_cast<std::uint16_t>(position);
+      put('_');
+    }
+    put('\n');
+  }
+
+  return result;
+}()};
+}  // namespace
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::format_grid(char* const out) const noexcept
+  -> char*
+{
+  const grid_layout<BoxSize>& grid {layout<BoxSize>};
+
+  std::ranges::copy(grid.text, out);
+
+  for ( std::size_t i {0}; i < cell_count; ++i ) {
+    out[grid.cell_offsets[i]] = m_data[i];
+  }
+
+  return out + grid_size;
+}
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::format_line(char* const out) const noexcept
+  -> char*
+{
+  return std::ranges::copy(m_data, out).out;
+}
+
+#define INSTANTIATE_FORMATTER(box_size)                            \
+  template auto basic_sudoku<box_size>::format_grid(char*) const \
+    noexcept -> char*;                                            \
+  template auto basic_sudoku<box_size>::format_line(char*) const \
+    noexcept -> char*;
+
+INSTANTIATE_FORMATTER(2)
+INSTANTIATE_FORMATTER(3)
+INSTANTIATE_FORMATTER(4)
+INSTANTIATE_FORMATTER(5)
+
+#undef INSTANTIATE_FORMATTER
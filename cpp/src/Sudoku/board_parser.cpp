@@ -0,0 +1,414 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+#include "board_parser.hpp"
+#include "sudoku.hpp"
+
+auto operator<<(std::ostream& out, const parse_error& rhs)
+  -> std::ostream&
+{
+  out << "line " << rhs.line << ", column " << rhs.column << ": ";
+
+  const auto print_character {[&out, &rhs]() {
+    const auto code {static_cast<unsigned char>(rhs.character)};
+
+    if ( std::isprint(code) != 0 ) {
+      out << '\'' << rhs.character << '\'';
+    } else {
+      out << "byte " << static_cast<unsigned>(code);
+    }
+  }};
+
+  switch ( rhs.kind ) {
+    case parse_error_kind::none:
+      out << "no error";
+      break;
+    case parse_error_kind::bad_character:
+      out << "unexpected ";
+      print_character();
+      out << " after " << rhs.cell_count << " cells";
+      break;
+    case parse_error_kind::too_few_cells:
+      out << "input ends after only " << rhs.cell_count << " cells";
+      break;
+    case parse_error_kind::too_many_cells:
+      out << "extra cell ";
+      print_character();
+      out << " after the last of " << rhs.cell_count;
+      break;
+  }
+
+  return out;
+}
+
+namespace {
+enum class symbol_class : std::uint8_t {
+  separator,
+  digit,
+  blank,
+  bad,
+};
+
+template <unsigned BoxSize>
+constexpr std::array<symbol_class, 256> symbol_classes {[]() {
+  using board_t = basic_sudoku<BoxSize>;
+
+  std::array<symbol_class, 256> classes {};
+
+  for ( unsigned code {0}; code < classes.size(); ++code ) {
+    const auto symbol {static_cast<char>(code)};
+
+    classes.at(code) = board_t::is_digit_symbol(symbol)
+                       ? symbol_class::digit
+                     : board_t::is_blank_symbol(symbol)
+                       ? symbol_class::blank
+                     : board_t::is_separator_symbol(symbol)
+                       ? symbol_class::separator
+                       : symbol_class::bad;
+  }
+
+  return classes;
+}()};
+
+template <unsigned BoxSize>
+struct parse_state {
+  std::array<char, basic_sudoku<BoxSize>::cell_count> cells {};
+  std::size_t cell_count {0};
+
+  parse_error_kind error {parse_error_kind::none};
+  std::size_t error_offset {};
+};
+
+// read text from first to last a byte at a time,
+// returning false at the first error
+template <unsigned BoxSize>
+auto read_bytes(const std::string_view text,
+                const std::size_t first,
+                const std::size_t last,
+                parse_state<BoxSize>& state) noexcept -> bool
+{
+  for ( std::size_t i {first}; i < last; ++i ) {
+    const char symbol {text[i]};
+    const auto code {static_cast<unsigned char>(symbol)};
+
+    switch ( symbol_classes<BoxSize>[code] ) {
+      case symbol_class::separator:
+        continue;
+      case symbol_class::bad:
+        state.error = parse_error_kind::bad_character;
+        state.error_offset = i;
+        return false;
+      case symbol_class::digit:
+      case symbol_class::blank:
+        break;
+    }
+
+    if ( state.cell_count == state.cells.size() ) {
+      state.error = parse_error_kind::too_many_cells;
+      state.error_offset = i;
+      return false;
+    }
+
+    state.cells[state.cell_count++] =
+      basic_sudoku<BoxSize>::is_blank_symbol(symbol) ? '_' : symbol;
+  }
+
+  return true;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+// Each byte of a vector is compared against the ranges and characters
+// of every class at once, the results collected as one bit per byte.
+// A vector holding only cells and separators, with room left for its
+// cells, is taken whole: stored straight into the board when every byte
+// is a cell, as in the one-line format, and a cell at a time otherwise.
+// Anything else goes to read_bytes, which finds the error in order.
+
+#  if defined(__AVX2__)
+
+using byte_vector = __m256i;
+using lane_bits_t = std::uint32_t;
+constexpr std::size_t vector_width {32};
+
+auto load(const char* const bytes) noexcept -> byte_vector
+{
+  // NOLINTNEXTLINE(*-reinterpret-cast)
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+}
+
+void store(char* const bytes, const byte_vector vec) noexcept
+{
+  // NOLINTNEXTLINE(*-reinterpret-cast)
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes), vec);
+}
+
+auto broadcast(const char byte) noexcept -> byte_vector
+{
+  return _mm256_set1_epi8(byte);
+}
+
+auto equal(const byte_vector lhs, const char rhs) noexcept -> byte_vector
+{
+  return _mm256_cmpeq_epi8(lhs, broadcast(rhs));
+}
+
+auto greater(const byte_vector lhs, const byte_vector rhs) noexcept
+  -> byte_vector
+{
+  return _mm256_cmpgt_epi8(lhs, rhs);
+}
+
+auto either(const byte_vector lhs, const byte_vector rhs) noexcept
+  -> byte_vector
+{
+  return _mm256_or_si256(lhs, rhs);
+}
+
+auto both(const byte_vector lhs, const byte_vector rhs) noexcept
+  -> byte_vector
+{
+  return _mm256_and_si256(lhs, rhs);
+}
+
+// bytes of if_set where mask is set, of otherwise elsewhere
+auto select(const byte_vector mask,
+            const byte_vector if_set,
+            const byte_vector otherwise) noexcept -> byte_vector
+{
+  return _mm256_blendv_epi8(otherwise, if_set, mask);
+}
+
+auto lane_bits(const byte_vector mask) noexcept -> lane_bits_t
+{
+  return static_cast<lane_bits_t>(_mm256_movemask_epi8(mask));
+}
+
+#  else
+
+using byte_vector = __m128i;
+using lane_bits_t = std::uint32_t;
+constexpr std::size_t vector_width {16};
+
+auto load(const char* const bytes) noexcept -> byte_vector
+{
+  // NOLINTNEXTLINE(*-reinterpret-cast)
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+}
+
+void store(char* const bytes, const byte_vector vec) noexcept
+{
+  // NOLINTNEXTLINE(*-reinterpret-cast)
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), vec);
+}
+
+auto broadcast(const char byte) noexcept -> byte_vector
+{
+  return _mm_set1_epi8(byte);
+}
+
+auto equal(const byte_vector lhs, const char rhs) noexcept -> byte_vector
+{
+  return _mm_cmpeq_epi8(lhs, broadcast(rhs));
+}
+
+auto greater(const byte_vector lhs, const byte_vector rhs) noexcept
+  -> byte_vector
+{
+  return _mm_cmpgt_epi8(lhs, rhs);
+}
+
+auto either(const byte_vector lhs, const byte_vector rhs) noexcept
+  -> byte_vector
+{
+  return _mm_or_si128(lhs, rhs);
+}
+
+auto both(const byte_vector lhs, const byte_vector rhs) noexcept
+  -> byte_vector
+{
+  return _mm_and_si128(lhs, rhs);
+}
+
+// bytes of if_set where mask is set, of otherwise elsewhere
+auto select(const byte_vector mask,
+            const byte_vector if_set,
+            const byte_vector otherwise) noexcept -> byte_vector
+{
+  return _mm_or_si128(_mm_and_si128(mask, if_set),
+                      _mm_andnot_si128(mask, otherwise));
+}
+
+auto lane_bits(const byte_vector mask) noexcept -> lane_bits_t
+{
+  return static_cast<lane_bits_t>(_mm_movemask_epi8(mask));
+}
+
+#  endif
+
+constexpr lane_bits_t all_lanes {
+  static_cast<lane_bits_t>((std::uint64_t {1} << vector_width) - 1)};
+
+// bytes from low to high inclusive,
+// compared as signed so that bytes past 0x7F never are
+auto in_range(const byte_vector bytes,
+              const char low,
+              const char high) noexcept -> byte_vector
+{
+  return both(greater(bytes, broadcast(static_cast<char>(low - 1))),
+              greater(broadcast(static_cast<char>(high + 1)), bytes));
+}
+
+// read vector_width bytes at once,
+// returning false if they must be read a byte at a time instead
+template <unsigned BoxSize>
+auto read_vector(const char* const bytes,
+                 parse_state<BoxSize>& state) noexcept -> bool
+{
+  constexpr unsigned side {basic_sudoku<BoxSize>::side};
+
+  const byte_vector input {load(bytes)};
+
+  byte_vector digits {in_range(
+    input, '1', static_cast<char>(side < 9 ? '0' + side : '9'))};
+  if constexpr ( side > 9 ) {
+    digits = either(
+      digits, in_range(input, 'A', static_cast<char>('A' + side - 10)));
+  }
+
+  const byte_vector blanks {either(
+    equal(input, '_'), either(equal(input, '.'), equal(input, '0')))};
+
+  const byte_vector separators {
+    either(either(in_range(input, '\t', '\r'), equal(input, ' ')),
+           either(equal(input, '|'),
+                  either(equal(input, '-'), equal(input, '+'))))};
+
+  const lane_bits_t cell_bits {lane_bits(either(digits, blanks))};
+
+  if ( (cell_bits | lane_bits(separators)) != all_lanes
+       || state.cell_count + static_cast<std::size_t>(std::popcount(
+            cell_bits))
+            > state.cells.size() ) {
+    return false;
+  }
+
+  const byte_vector cells {select(blanks, broadcast('_'), input)};
+
+  if ( cell_bits == all_lanes ) {
+    store(state.cells.data() + state.cell_count, cells);
+    state.cell_count += vector_width;
+    return true;
+  }
+
+  std::array<char, vector_width> normalized {};
+  store(normalized.data(), cells);
+
+  for ( lane_bits_t rest {cell_bits}; rest != 0; rest &= rest - 1 ) {
+    state.cells[state.cell_count++] =
+      normalized[static_cast<std::size_t>(std::countr_zero(rest))];
+  }
+
+  return true;
+}
+
+#endif
+
+auto make_error(const std::string_view text,
+                const parse_error_kind kind,
+                const std::size_t offset,
+                const std::size_t cell_count) noexcept -> parse_error
+{
+  const std::string_view before {text.substr(0, offset)};
+  const std::size_t line_start {before.rfind('\n')};
+
+  return {
+    .kind = kind,
+    .offset = offset,
+    .line = static_cast<std::size_t>(std::ranges::count(before, '\n')) + 1,
+    .column = offset
+            - (line_start == std::string_view::npos ? 0 : line_start + 1)
+            + 1,
+    .character = offset < text.size() ? text[offset] : '\0',
+    .cell_count = cell_count,
+  };
+}
+}  // namespace
+
+template <unsigned BoxSize>
+auto parse_board(const std::string_view text) noexcept
+  -> board_parse_result<BoxSize>
+{
+  parse_state<BoxSize> state {};
+  std::size_t position {0};
+
+  const auto failure {[&text, &state]() -> board_parse_result<BoxSize> {
+    return {std::nullopt,
+            make_error(
+              text, state.error, state.error_offset, state.cell_count)};
+  }};
+
+#if defined(__AVX2__) || defined(__SSE2__)
+  for ( ; position + vector_width <= text.size();
+        position += vector_width ) {
+    const std::size_t next {position + vector_width};
+
+    if ( ! read_vector(text.data() + position, state)
+         && ! read_bytes(text, position, next, state) ) {
+      return failure();
+    }
+  }
+#endif
+
+  if ( ! read_bytes(text, position, text.size(), state) ) {
+    return failure();
+  }
+
+  if ( state.cell_count < state.cells.size() ) {
+    state.error = parse_error_kind::too_few_cells;
+    state.error_offset = text.size();
+    return failure();
+  }
+
+  return {basic_sudoku<BoxSize> {state.cells}, {}};
+}
+
+auto count_cell_symbols(const std::string_view text) noexcept
+  -> std::size_t
+{
+  return static_cast<std::size_t>(
+    std::ranges::count_if(text, [](const char symbol) {
+      return ! Sudoku::is_separator_symbol(symbol);
+    }));
+}
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::from_line(const std::string_view line) noexcept
+  -> std::optional<basic_sudoku>
+{
+  return parse_board<BoxSize>(line).board;
+}
+
+#define INSTANTIATE_PARSER(box_size)                                 \
+  template auto parse_board<box_size>(std::string_view) noexcept     \
+    -> board_parse_result<box_size>;                                 \
+  template auto basic_sudoku<box_size>::from_line(std::string_view) \
+    noexcept -> std::optional<basic_sudoku<box_size>>;
+
+INSTANTIATE_PARSER(2)
+INSTANTIATE_PARSER(3)
+INSTANTIATE_PARSER(4)
+INSTANTIATE_PARSER(5)
+
+#undef INSTANTIATE_PARSER
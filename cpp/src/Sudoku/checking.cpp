@@ -2,327 +2,546 @@
 #include <array>
 #include <bitset>
 #include <cassert>
+#include <cstdint>
 #include <ranges>
 
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#  include <immintrin.h>
+#endif
+
 #include <supl/utility.hpp>
 
 #include <mdspan/mdspan.hpp>
 
-#include "section_table.hpp"
 #include "sudoku.hpp"
 
-static auto is_populated(const Sudoku& sudoku) noexcept -> bool
+template <unsigned BoxSize>
+static auto is_populated(const basic_sudoku<BoxSize>& sudoku) noexcept
+  -> bool
 {
-  return std::ranges::find(sudoku.data(), '_') == end(sudoku.data());
+  return sudoku.masks().populated_count == sudoku.cell_count;
 }
 
-// anonymous namespace to enforce internal linkage
+#if defined(__AVX2__) || defined(__SSE4_1__)
+
+// Whole-board kernel: each row is widened into 16 lanes of 16 bits,
+// cell i of the row holding its digit one-hot in lane i
+// (lanes 9 through 15 are always zero).
+// Columns then reduce vertically across the nine row vectors,
+// rows reduce horizontally within each vector,
+// and boxes reduce horizontally within each band's column masks.
+// A duplicate is any bit found set in two ranges being merged.
+
 namespace {
-// function object implementing a single cell check
-// to be used in a loop over a single entire constraint region
-// (row, column, section)
-//
-// check_table must be reset between region checks
-struct check_iteration_handler {
 
-  // NOLINTNEXTLINE(*member*)
-  std::bitset<9> check_table;
+#  if defined(__AVX2__)
 
-  auto operator()(const char cell) noexcept -> bool
-  {
-    if ( cell == '_' ) {
-      return true;
-    }
+struct lane_vector {
+  __m256i lanes;
+};
 
-    // a char which is a digit has numerical value:
-    // (stoi(to_string(the_char)) + '0')
-    // thus, (cell - '0') will map '2' to 2
-    // this is off-by-one of the desired index into the check_table,
-    // so, this line maps '2' to 1
-    const auto raw_idx {(cell - '0') - 1};
+auto operator|(const lane_vector lhs, const lane_vector rhs) noexcept
+  -> lane_vector
+{
+  return {_mm256_or_si256(lhs.lanes, rhs.lanes)};
+}
 
-    // sanity checks, guaranteed to hold if value of cell
-    // is numeric or '_' ('_' handled by early exit)
-    assert(raw_idx >= 0);
-    assert(raw_idx <= 8);
-    assert(supl::to_string(raw_idx + 1) == supl::to_string(cell));
+auto operator&(const lane_vector lhs, const lane_vector rhs) noexcept
+  -> lane_vector
+{
+  return {_mm256_and_si256(lhs.lanes, rhs.lanes)};
+}
 
-    const unsigned idx {static_cast<unsigned>(raw_idx)};
+auto zero_lanes() noexcept -> lane_vector
+{
+  return {_mm256_setzero_si256()};
+}
 
-    // duplicate checking: if '2' appears twice,
-    // check_table[1] will already be set
-    if ( check_table.test(idx) ) {
-      return false;
-    } else {
-      check_table.set(idx);
-    }
+auto from_halves(const __m128i low, const __m128i high) noexcept
+  -> lane_vector
+{
+  return {_mm256_set_m128i(high, low)};
+}
 
-    return true;
+// lane i takes the value of lane (i + Count), zero filling the top
+template <int Count>
+auto shift_down(const lane_vector vec) noexcept -> lane_vector
+{
+  // top half moved down into the bottom half, zeroes above
+  const __m256i upper {
+    _mm256_permute2x128_si256(vec.lanes, vec.lanes, 0x81)};
+
+  if constexpr ( Count == 8 ) {
+    return {upper};
+  } else {
+    return {_mm256_alignr_epi8(upper, vec.lanes, Count * 2)};
   }
+}
 
-  void reset() noexcept
-  {
-    check_table.reset();
-  }
+auto any_set(const lane_vector vec) noexcept -> bool
+{
+  return _mm256_testz_si256(vec.lanes, vec.lanes) == 0;
+}
 
-  void set(unsigned idx) noexcept
-  {
-    check_table.set(idx);
-  }
-};
-}  // namespace
+// bits of rhs not set in lhs
+auto and_not(const lane_vector lhs, const lane_vector rhs) noexcept
+  -> lane_vector
+{
+  return {_mm256_andnot_si256(lhs.lanes, rhs.lanes)};
+}
 
-// Only determines if constraints are intact
-// A partially-filled board which does not violate constraints will return true
-static auto is_legal_state(const Sudoku& sudoku) noexcept -> bool
+// all bits set in each lane which is zero
+auto zero_lane_mask(const lane_vector vec) noexcept -> lane_vector
 {
-  const auto data_view = sudoku.mdview();
+  return {_mm256_cmpeq_epi16(vec.lanes, _mm256_setzero_si256())};
+}
 
-  // returns true if iteration is ok (indeterminate for complete board)
-  // returns false if iteration is bad (definitively board is in illegal state)
-  check_iteration_handler check_iteration {};
+auto broadcast(const std::uint16_t value) noexcept -> lane_vector
+{
+  return {_mm256_set1_epi16(static_cast<short>(value))};
+}
 
-  // check row-wise
+auto load(const std::array<std::uint16_t, 16>& in) noexcept
+  -> lane_vector
+{
+  return {
+    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.data()))};
+}
 
-  for ( const unsigned row : std::views::iota(0U, 9U) ) {
-    for ( const unsigned col : std::views::iota(0U, 9U) ) {
-      if ( ! check_iteration(data_view(row, col)) ) {
-        return false;
-      }
-    }
+// writes all 16 lanes
+void store(const lane_vector vec, std::uint16_t* const out) noexcept
+{
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), vec.lanes);
+}
 
-    check_iteration.reset();
-  }
+#  else
 
-  // rows are good
+struct lane_vector {
+  __m128i low;
+  __m128i high;
+};
 
-  // row check alone is adequate for a populated board
-  // early exit
-  if ( is_populated(sudoku) ) {
-    return true;
-  }
+auto operator|(const lane_vector lhs, const lane_vector rhs) noexcept
+  -> lane_vector
+{
+  return {_mm_or_si128(lhs.low, rhs.low),
+          _mm_or_si128(lhs.high, rhs.high)};
+}
 
-  // check column-wise
-  for ( const unsigned col : std::views::iota(0U, 9U) ) {
-    for ( const unsigned row : std::views::iota(0U, 9U) ) {
-      if ( ! check_iteration(data_view(row, col)) ) {
-        return false;
-      }
-    }
+auto operator&(const lane_vector lhs, const lane_vector rhs) noexcept
+  -> lane_vector
+{
+  return {_mm_and_si128(lhs.low, rhs.low),
+          _mm_and_si128(lhs.high, rhs.high)};
+}
 
-    check_iteration.reset();
+auto zero_lanes() noexcept -> lane_vector
+{
+  return {_mm_setzero_si128(), _mm_setzero_si128()};
+}
+
+auto from_halves(const __m128i low, const __m128i high) noexcept
+  -> lane_vector
+{
+  return {low, high};
+}
+
+// lane i takes the value of lane (i + Count), zero filling the top
+template <int Count>
+auto shift_down(const lane_vector vec) noexcept -> lane_vector
+{
+  if constexpr ( Count == 8 ) {
+    return {vec.high, _mm_setzero_si128()};
+  } else {
+    return {_mm_alignr_epi8(vec.high, vec.low, Count * 2),
+            _mm_srli_si128(vec.high, Count * 2)};
   }
+}
 
-  // columns are good
+auto any_set(const lane_vector vec) noexcept -> bool
+{
+  const __m128i both {_mm_or_si128(vec.low, vec.high)};
+  return _mm_testz_si128(both, both) == 0;
+}
 
-  // check sections
-  for ( const auto& section : section_table ) {
-    for ( const auto& [row, col] : section ) {
-      if ( const bool ok_so_far {check_iteration(data_view(row, col))};
-           ! ok_so_far ) {
-        return false;
-      }
-    }
+// bits of rhs not set in lhs
+auto and_not(const lane_vector lhs, const lane_vector rhs) noexcept
+  -> lane_vector
+{
+  return {_mm_andnot_si128(lhs.low, rhs.low),
+          _mm_andnot_si128(lhs.high, rhs.high)};
+}
 
-    check_iteration.reset();
-  }
+// all bits set in each lane which is zero
+auto zero_lane_mask(const lane_vector vec) noexcept -> lane_vector
+{
+  return {_mm_cmpeq_epi16(vec.low, _mm_setzero_si128()),
+          _mm_cmpeq_epi16(vec.high, _mm_setzero_si128())};
+}
 
-  return true;
+auto broadcast(const std::uint16_t value) noexcept -> lane_vector
+{
+  const __m128i lanes {_mm_set1_epi16(static_cast<short>(value))};
+  return {lanes, lanes};
 }
 
-auto Sudoku::is_solved() const noexcept -> bool
+auto load(const std::array<std::uint16_t, 16>& in) noexcept
+  -> lane_vector
 {
-  return is_populated(*this) && is_legal_state(*this);
+  return {
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data())),
+    _mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + 8))};
 }
 
-auto Sudoku::is_valid() const noexcept -> bool
+// writes all 16 lanes
+void store(const lane_vector vec, std::uint16_t* const out) noexcept
 {
-  return is_legal_state(*this);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), vec.low);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), vec.high);
 }
 
-auto Sudoku::is_legal_assignment(const index_pair idxs,
-                                 const char value) const noexcept -> bool
+#  endif
+
+// one-hot lanes for the nine cells of a row
+auto load_row(const std::array<char, 81>& cells,
+              const unsigned row) noexcept -> lane_vector
 {
-  // value must be in the widest domain
-  assert(value >= '1');
-  assert(value <= '9');
+  // a 16 byte load from the last row would run off the board,
+  // so it loads the 16 bytes ending at the last cell instead
+  // and shifts the row down into place
+  const auto* const source {reinterpret_cast<const __m128i*>(
+    cells.data() + (row < 8 ? row * 9 : 81 - 16))};
+  const __m128i bytes {row < 8
+                         ? _mm_loadu_si128(source)
+                         : _mm_srli_si128(_mm_loadu_si128(source), 7)};
+
+  // '1' through '9' map to 0 through 8,
+  // '_' maps to 46, which has a low nibble of 14,
+  // and bytes past the row get their high bit set.
+  // A shuffle byte with the high bit set yields 0,
+  // otherwise it indexes the table with its low nibble.
+  const __m128i past_row {_mm_setr_epi8(
+    0, 0, 0, 0, 0, 0, 0, 0, 0, -128, -128, -128, -128, -128, -128, -128)};
+  const __m128i digit_idx {
+    _mm_or_si128(_mm_sub_epi8(bytes, _mm_set1_epi8('1')), past_row)};
+
+  // low and high byte of each digit's bit
+  const __m128i low_table {
+    _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0)};
+  const __m128i high_table {
+    _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0)};
+
+  const __m128i low_bytes {_mm_shuffle_epi8(low_table, digit_idx)};
+  const __m128i high_bytes {_mm_shuffle_epi8(high_table, digit_idx)};
+
+  return from_halves(_mm_unpacklo_epi8(low_bytes, high_bytes),
+                     _mm_unpackhi_epi8(low_bytes, high_bytes));
+}
 
-  const auto data_view = this->mdview();
+// merge incoming into seen, recording bits present in both
+void accumulate(lane_vector& seen,
+                lane_vector& duplicates,
+                const lane_vector incoming) noexcept
+{
+  duplicates = duplicates | (seen & incoming);
+  seen = seen | incoming;
+}
 
-  // only unpopulated cells may be assigned to
-  if ( data_view(idxs.row, idxs.col) != '_' ) {
-    return false;
+// lane 0 of seen becomes the union of all lanes,
+// any duplicate among the lanes is recorded in duplicates
+template <int Count>
+void fold_lanes(lane_vector& seen, lane_vector& duplicates) noexcept
+{
+  // lane i of seen covers lanes [i, i + Count)
+  accumulate(seen, duplicates, shift_down<Count>(seen));
+
+  if constexpr ( Count < 8 ) {
+    fold_lanes<Count * 2>(seen, duplicates);
   }
+}
 
-  check_iteration_handler check_iteration {};
+// Sudoku::rebuild_masks
+auto kernel_masks(const std::array<char, 81>& cells) noexcept
+  -> Sudoku::occupancy_masks
+{
+  Sudoku::occupancy_masks masks {};
 
-  const auto raw_idx {(value - '0') - 1};
+  lane_vector col_seen {zero_lanes()};
+  lane_vector duplicates {zero_lanes()};
+  std::array<std::uint16_t, 16> lanes {};
 
-  // sanity checks, guaranteed to hold if value of cell is valid
-  // (checked by previous assert)
-  assert(raw_idx >= 0);
-  assert(raw_idx <= 8);
-  assert(supl::to_string(raw_idx + 1) == supl::to_string(value));
+  for ( const unsigned band : std::views::iota(0U, 3U) ) {
+    lane_vector band_seen {zero_lanes()};
 
-  // index for
-  const unsigned idx {static_cast<unsigned>(raw_idx)};
+    for ( const unsigned row : std::views::iota(band * 3, band * 3 + 3) ) {
+      const lane_vector row_cells {load_row(cells, row)};
 
-  // check across column
-  check_iteration.set(idx);
-  for ( const unsigned row : std::views::iota(0U, 9U) ) {
-    if ( ! check_iteration(data_view(row, idxs.col)) ) {
-      return false;
+      accumulate(col_seen, duplicates, row_cells);
+      band_seen = band_seen | row_cells;
+
+      lane_vector row_seen {row_cells};
+      fold_lanes<1>(row_seen, duplicates);
+      store(row_seen, lanes.data());
+      masks.rows.at(row) = lanes[0];
     }
-  }
 
-  check_iteration.reset();
+    // within a band, the columns of a box were merged vertically,
+    // so lanes 0, 3 and 6 merge the next two lanes for the boxes
+    const lane_vector next {shift_down<1>(band_seen)};
+    const lane_vector after_next {shift_down<2>(band_seen)};
 
-  check_iteration.set(idx);
-  for ( const unsigned col : std::views::iota(0U, 9U) ) {
-    if ( ! check_iteration(data_view(idxs.row, col)) ) {
-      return false;
+    store((band_seen & next) | (band_seen & after_next)
+            | (next & after_next),
+          lanes.data());
+    masks.has_conflict |= (lanes[0] | lanes[3] | lanes[6]) != 0;
+
+    store(band_seen | next | after_next, lanes.data());
+    for ( const unsigned box : std::views::iota(0U, 3U) ) {
+      masks.boxes.at(band * 3 + box) = lanes.at(box * 3);
     }
   }
 
-  check_iteration.reset();
+  store(col_seen, lanes.data());
+  std::copy_n(lanes.begin(), 9, masks.cols.begin());
 
-  check_iteration.set(idx);
+  masks.has_conflict |= any_set(duplicates);
+  masks.populated_count = static_cast<unsigned>(
+    81 - std::ranges::count(cells, '_'));
 
-  // get subtable in section_table which contains indices in question
-  const auto& section_subtable {[&]() {
-    for ( const auto& subtable : section_table ) {
-      if ( std::ranges::find(subtable, idxs) != subtable.end() ) {
-        return subtable;
-      }
+  return masks;
+}
+
+// Sudoku::all_candidates, a row of candidates at a time:
+// the row's mask is broadcast to every lane,
+// column masks sit in their own lanes,
+// and each box mask fills the three lanes of its columns
+auto kernel_candidates(const std::array<char, 81>& cells,
+                       const Sudoku::occupancy_masks& masks) noexcept
+  -> Sudoku::candidate_masks
+{
+  std::array<std::uint16_t, 16> lanes {};
+  std::copy_n(masks.cols.begin(), 9, lanes.begin());
+  const lane_vector col_masks {load(lanes)};
+  const lane_vector all_digits {broadcast(0x1FF)};
+
+  Sudoku::candidate_masks result;
+
+  // all bits set in the three lanes of each box in a band
+  constexpr static auto box_lanes {[]() {
+    std::array<std::array<std::uint16_t, 16>, 3> table {};
+    for ( const unsigned box : std::views::iota(0U, 3U) ) {
+      std::fill_n(table.at(box).begin() + box * 3, 3, 0xFFFF);
     }
-    assert(false);
+    return table;
   }()};  // Immediately Invoked Lambda Expression
 
-  for ( const auto& [row, col] : section_subtable ) {
-    if ( ! check_iteration(data_view(row, col)) ) {
-      return false;
+  for ( const unsigned band : std::views::iota(0U, 3U) ) {
+    lane_vector occupied_by_band {col_masks};
+    for ( const unsigned box : std::views::iota(0U, 3U) ) {
+      occupied_by_band = occupied_by_band
+                       | (broadcast(masks.boxes.at(band * 3 + box))
+                          & load(box_lanes.at(box)));
+    }
+
+    for ( const unsigned row : std::views::iota(band * 3, band * 3 + 3) ) {
+      const lane_vector occupied {occupied_by_band
+                                  | broadcast(masks.rows.at(row))};
+
+      // populated cells have no candidates
+      const lane_vector row_candidates {
+        and_not(occupied, all_digits)
+        & zero_lane_mask(load_row(cells, row))};
+
+      // lanes past the row spill into the next row,
+      // which overwrites them, except for the last row
+      if ( row < 8 ) {
+        store(row_candidates, result.data() + row * 9);
+      } else {
+        store(row_candidates, lanes.data());
+        std::copy_n(lanes.begin(), 9, result.begin() + 72);
+      }
     }
   }
 
-  return true;
+  return result;
 }
 
-///////////////////////////////////////////// DOMAINS
+}  // namespace
 
-// get remaining domain of each unassigned variable
-// and check for any variable with a null domain
-//
-// find '_' and save positions,
-// trim down domain by walking the enclosing row, col, and section
+#endif
 
-auto Sudoku::query_domains() const noexcept
-  -> std::array<variable_domain, 81>
+// walk the board once, recording each digit in the masks
+// of its row, column, and box
+//
+// a digit already present in any of the three masks is a duplicate
+template <unsigned BoxSize>
+void basic_sudoku<BoxSize>::rebuild_masks() noexcept
 {
-  std::array<variable_domain, 81> domains;
-  const Kokkos::mdspan<variable_domain, Kokkos::extents<unsigned, 9, 9>>
-    domain_view {domains.data()};
+#if defined(__AVX2__) || defined(__SSE4_1__)
+  if constexpr ( BoxSize == 3 ) {
+    m_masks = kernel_masks(m_data);
+    return;
+  }
+#endif
 
-  const auto board_view {this->mdview()};
+  occupancy_masks masks {};
 
-  // initialize
-  for ( const unsigned row : std::views::iota(0U, 9U) ) {
-    for ( const unsigned col : std::views::iota(0U, 9U) ) {
-      domain_view(row, col) = {
-        {row, col},
-        {}, // default-constructed bitset is all 0s
-        board_view(row, col)
-      };
-    }
-  }
+  for ( const unsigned row : std::views::iota(0U, side) ) {
+    for ( const unsigned col : std::views::iota(0U, side) ) {
+      const char cell {m_data.at(row * side + col)};
 
-  // set domain for unassigned cells (will be reduced)
-  for ( auto& domain : domains ) {
-    if ( domain.value == '_' ) {
-      domain.legal_assignments.reset();
-      domain.legal_assignments.flip();
-    }
-  }
+      if ( cell == '_' ) {
+        continue;
+      }
 
-  // reduce by row
-  for ( auto& domain : domains ) {
-    // skip assigned cells
-    if ( domain.value != '_' ) {
-      continue;
-    }
+      // sanity check, guaranteed to hold if value of cell
+      // is a digit or '_' ('_' handled by early exit)
+      assert(is_digit_symbol(cell));
 
-    const unsigned row {domain.idxs.row};
-    for ( const unsigned col : std::views::iota(0U, 9U) ) {
-      // assigned cell means domain may be able to be reduced
-      const char cell_value {board_view(row, col)};
-      if ( cell_value != '_' ) {
-        domain.legal_assignments.reset(
-          static_cast<unsigned>(cell_value - '0' - 1));
+      // digit_index maps '2' to 1, its bit in the masks
+      const auto bit {static_cast<mask_t>(1U << digit_index(cell))};
+      mask_t& row_mask {masks.rows.at(row)};
+      mask_t& col_mask {masks.cols.at(col)};
+      mask_t& box_mask {masks.boxes.at(box_index({row, col}))};
+
+      // duplicate checking: if '2' appears twice in a unit,
+      // its bit will already be set
+      if ( ((row_mask | col_mask | box_mask) & bit) != 0 ) {
+        masks.has_conflict = true;
       }
+
+      row_mask |= bit;
+      col_mask |= bit;
+      box_mask |= bit;
+      ++masks.populated_count;
     }
   }
 
-  // reduce by column
-  for ( auto& domain : domains ) {
-    // skip assigned cells
-    if ( domain.value != '_' ) {
-      continue;
-    }
+  m_masks = masks;
+}
 
-    const unsigned col {domain.idxs.col};
-    for ( const unsigned row : std::views::iota(0U, 9U) ) {
-      // assigned cell means domain may be able to be reduced
-      const char cell_value {board_view(row, col)};
-      if ( cell_value != '_' ) {
-        domain.legal_assignments.reset(
-          static_cast<unsigned>(cell_value - '0' - 1));
-      }
-    }
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::all_candidates() const noexcept
+  -> candidate_masks
+{
+#if defined(__AVX2__) || defined(__SSE4_1__)
+  if constexpr ( BoxSize == 3 ) {
+    return kernel_candidates(m_data, this->masks());
   }
+#endif
 
-  // reduce by section
-  for ( auto& domain : domains ) {
-    // get subtable in section_table which contains indices in question
-    const auto& section_subtable {[&]() {
-      for ( const auto& subtable : section_table ) {
-        if ( std::ranges::find(subtable, domain.idxs) != subtable.end() ) {
-          return subtable;
-        }
-      }
-      assert(false);
-    }()};  // Immediately Invoked Lambda Expression
-
-    // walk the subtable of section indices
-    for ( const auto& [row, col] : section_subtable ) {
-      // assigned cell means domain may be able to be reduced
-      const char cell_value {board_view(row, col)};
-      if ( cell_value != '_' ) {
-        domain.legal_assignments.reset(
-          static_cast<unsigned>(cell_value - '0' - 1));
-      }
+  candidate_masks result;
+
+  for ( const unsigned row : std::views::iota(0U, side) ) {
+    for ( const unsigned col : std::views::iota(0U, side) ) {
+      result.at(row * side + col) =
+        static_cast<mask_t>(this->candidates({row, col}).to_ulong());
     }
   }
 
-  return domains;
+  return result;
 }
 
-// determines if legal assignments exist
-auto Sudoku::has_legal_assignments() const noexcept -> bool
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::candidates(const index_pair idxs) const noexcept
+  -> std::bitset<side>
+{
+  if ( this->mdview()(idxs.row, idxs.col) != '_' ) {
+    return {};
+  }
+
+  const auto& masks {this->masks()};
+
+  const auto occupied {static_cast<unsigned>(
+    masks.rows.at(idxs.row) | masks.cols.at(idxs.col)
+    | masks.boxes.at(box_index(idxs)))};
+
+  return std::bitset<side> {~occupied & ((1U << side) - 1)};
+}
+
+// Only determines if constraints are intact
+// A partially-filled board which does not violate constraints will return true
+template <unsigned BoxSize>
+static auto is_legal_state(const basic_sudoku<BoxSize>& sudoku) noexcept
+  -> bool
+{
+  return ! sudoku.masks().has_conflict;
+}
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::is_solved() const noexcept -> bool
+{
+  return is_populated(*this) && is_legal_state(*this);
+}
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::is_valid() const noexcept -> bool
+{
+  return is_legal_state(*this);
+}
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::is_legal_assignment(
+  const index_pair idxs, const char value) const noexcept -> bool
+{
+  // value must be in the widest domain
+  assert(is_digit_symbol(value));
+
+  // only unpopulated cells may be assigned to,
+  // which candidates() accounts for
+  return this->candidates(idxs).test(digit_index(value));
+}
+
+///////////////////////////////////////////// DOMAINS
+
+// get remaining domain of each unassigned variable
+//
+// a verbose view of all_candidates(),
+// which is cheaper where the cell and value are not needed
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::query_domains() const noexcept
+  -> std::array<variable_domain, 81>
+  requires (BoxSize == 3)
 {
+  const auto candidates {this->all_candidates()};
 
-  const auto domains {this->query_domains()};
+  std::array<variable_domain, 81> domains;
 
-  for ( const auto& domain : domains ) {
-    // skip populated cells
-    if ( domain.value != '_' ) {
-      continue;
+  for ( const unsigned row : std::views::iota(0U, 9U) ) {
+    for ( const unsigned col : std::views::iota(0U, 9U) ) {
+      const unsigned cell {row * 9 + col};
+      domains.at(cell) = {
+        {row, col},
+        candidates.at(cell),
+        m_data.at(cell)
+      };
     }
+  }
+
+  return domains;
+}
 
-    // cell value == '_' therefore is unpopulated
+// determines if legal assignments exist
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::has_legal_assignments() const noexcept -> bool
+{
+  const auto candidates {this->all_candidates()};
 
-    if ( domain.legal_assignments.none() ) {
+  for ( const unsigned cell : std::views::iota(0U, cell_count) ) {
+    // populated cells have no candidates, so skip them
+    if ( m_data.at(cell) == '_' && candidates.at(cell) == 0 ) {
       return false;
     }
   }
 
   return true;
 }
+
+// every supported board size
+// apply_trivial_move and solve are instantiated alongside their definitions
+
+template class basic_sudoku<2>;
+template class basic_sudoku<3>;
+template class basic_sudoku<4>;
+template class basic_sudoku<5>;
@@ -0,0 +1,277 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "corpus_reader.hpp"
+
+namespace {
+// how much a read() asks for at a time
+constexpr std::size_t read_size {std::size_t {1} << 16};
+
+// the end of the line starting at position, past its newline if it has
+// one, and whether it is blank
+//
+// the newline is found by memchr, which the C library vectorizes
+auto find_line_end(const std::string_view text,
+                   const std::size_t position) noexcept
+  -> std::pair<std::size_t, bool>
+{
+  const auto* const start {text.data() + position};
+  const std::size_t remaining {text.size() - position};
+
+  const auto* const newline {
+    static_cast<const char*>(std::memchr(start, '\n', remaining))};
+
+  const std::size_t length {newline == nullptr
+                              ? remaining
+                              : static_cast<std::size_t>(newline - start)};
+  const std::size_t end {position + length
+                         + (newline == nullptr ? 0 : 1)};
+
+  return {end, is_blank_line({start, length})};
+}
+}  // namespace
+
+corpus_reader::corpus_reader(const int descriptor,
+                             const bool owns_descriptor) noexcept
+    : m_descriptor {descriptor}
+    , m_owns_descriptor {owns_descriptor}
+{ }
+
+corpus_reader::corpus_reader(const std::string_view contents) noexcept
+    : m_contents {contents}
+{ }
+
+corpus_reader::corpus_reader(std::istream& in) noexcept
+    : m_stream {&in}
+{ }
+
+auto corpus_reader::open(const char* const path)
+  -> std::optional<corpus_reader>
+{
+  const int descriptor {::open(path, O_RDONLY | O_CLOEXEC)};
+
+  if ( descriptor < 0 ) {
+    return std::nullopt;
+  }
+
+  corpus_reader reader {descriptor, true};
+
+  struct stat status {};
+
+  // an empty file cannot be mapped, but neither does it need to be
+  if ( ::fstat(descriptor, &status) != 0 || ! S_ISREG(status.st_mode)
+       || status.st_size == 0 ) {
+    return reader;
+  }
+
+  const auto size {static_cast<std::size_t>(status.st_size)};
+  void* const mapping {
+    ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+
+  if ( mapping == MAP_FAILED ) {
+    return reader;
+  }
+
+  // read ahead aggressively, and drop pages soon after they are passed
+  static_cast<void>(::madvise(mapping, size, MADV_SEQUENTIAL));
+
+  reader.m_contents = {static_cast<const char*>(mapping), size};
+  reader.m_is_mapped = true;
+
+  // the mapping holds its own reference to the file
+  ::close(descriptor);
+  reader.m_descriptor = -1;
+  reader.m_owns_descriptor = false;
+
+  return reader;
+}
+
+auto corpus_reader::from_descriptor(const int descriptor) noexcept
+  -> corpus_reader
+{
+  return corpus_reader {descriptor, false};
+}
+
+corpus_reader::corpus_reader(corpus_reader&& other) noexcept
+    : m_contents {std::exchange(other.m_contents, {})}
+    , m_position {std::exchange(other.m_position, 0)}
+    , m_is_mapped {std::exchange(other.m_is_mapped, false)}
+    , m_descriptor {std::exchange(other.m_descriptor, -1)}
+    , m_owns_descriptor {std::exchange(other.m_owns_descriptor, false)}
+    , m_stream {std::exchange(other.m_stream, nullptr)}
+    , m_buffer {std::move(other.m_buffer)}
+    , m_buffer_start {std::exchange(other.m_buffer_start, 0)}
+    , m_at_end {other.m_at_end}
+    , m_failed {other.m_failed}
+{ }
+
+auto corpus_reader::operator=(corpus_reader&& other) noexcept
+  -> corpus_reader&
+{
+  if ( this != &other ) {
+    release();
+
+    m_contents = std::exchange(other.m_contents, {});
+    m_position = std::exchange(other.m_position, 0);
+    m_is_mapped = std::exchange(other.m_is_mapped, false);
+    m_descriptor = std::exchange(other.m_descriptor, -1);
+    m_owns_descriptor = std::exchange(other.m_owns_descriptor, false);
+    m_stream = std::exchange(other.m_stream, nullptr);
+    m_buffer = std::move(other.m_buffer);
+    m_buffer_start = std::exchange(other.m_buffer_start, 0);
+    m_at_end = other.m_at_end;
+    m_failed = other.m_failed;
+  }
+
+  return *this;
+}
+
+corpus_reader::~corpus_reader()
+{
+  release();
+}
+
+void corpus_reader::release() noexcept
+{
+  if ( m_is_mapped ) {
+    // NOLINTNEXTLINE(*-const-cast)
+    ::munmap(const_cast<char*>(m_contents.data()), m_contents.size());
+    m_is_mapped = false;
+  }
+
+  if ( m_owns_descriptor ) {
+    ::close(m_descriptor);
+    m_owns_descriptor = false;
+  }
+
+  m_descriptor = -1;
+}
+
+auto corpus_reader::next_block(const std::size_t max_lines)
+  -> corpus_block
+{
+  if ( m_descriptor < 0 && m_stream == nullptr ) {
+    return next_contents_block(max_lines);
+  }
+
+  return next_read_block(max_lines);
+}
+
+auto corpus_reader::next_contents_block(
+  const std::size_t max_lines) noexcept -> corpus_block
+{
+  corpus_block block {};
+
+  const std::size_t start {m_position};
+
+  while ( block.line_count < max_lines
+          && m_position < m_contents.size() ) {
+    const auto [end, is_blank] {find_line_end(m_contents, m_position)};
+
+    block.line_count += is_blank ? 0 : 1;
+    m_position = end;
+  }
+
+  block.text = m_contents.substr(start, m_position - start);
+  return block;
+}
+
+auto corpus_reader::read_more() -> bool
+{
+  if ( m_at_end ) {
+    return false;
+  }
+
+  const std::size_t old_size {m_buffer.size()};
+  m_buffer.resize(old_size + read_size);
+
+  std::size_t got {0};
+
+  if ( m_stream != nullptr ) {
+    m_stream->read(m_buffer.data() + old_size,
+                   static_cast<std::streamsize>(read_size));
+    got = static_cast<std::size_t>(m_stream->gcount());
+
+    if ( m_stream->bad() ) {
+      m_failed = true;
+    }
+  } else {
+    ssize_t result {-1};
+
+    do {
+      result =
+        ::read(m_descriptor, m_buffer.data() + old_size, read_size);
+    } while ( result < 0 && errno == EINTR );
+
+    if ( result < 0 ) {
+      m_failed = true;
+    } else {
+      got = static_cast<std::size_t>(result);
+    }
+  }
+
+  m_buffer.resize(old_size + got);
+
+  if ( got == 0 ) {
+    m_at_end = true;
+  }
+
+  return got != 0;
+}
+
+auto corpus_reader::next_read_block(const std::size_t max_lines)
+  -> corpus_block
+{
+  // drop what was handed out once it is most of the buffer,
+  // so each byte is moved a bounded number of times
+  if ( m_buffer_start > m_buffer.size() / 2 ) {
+    m_buffer.erase(m_buffer.begin(),
+                   m_buffer.begin()
+                     + static_cast<std::ptrdiff_t>(m_buffer_start));
+    m_buffer_start = 0;
+  }
+
+  corpus_block block {};
+
+  // every line before scanned is whole
+  std::size_t scanned {m_buffer_start};
+
+  while ( block.line_count < max_lines ) {
+    const std::string_view text {m_buffer.data(), m_buffer.size()};
+
+    if ( scanned < text.size() ) {
+      const auto [end, is_blank] {find_line_end(text, scanned)};
+
+      // a line with no newline yet is only whole at the end of input
+      if ( text.at(end - 1) == '\n' || m_at_end ) {
+        block.line_count += is_blank ? 0 : 1;
+        scanned = end;
+        continue;
+      }
+    }
+
+    if ( ! read_more() && scanned == m_buffer.size() ) {
+      break;
+    }
+  }
+
+  // the block owns a copy, as the buffer is reused
+  block.storage.assign(
+    m_buffer.begin() + static_cast<std::ptrdiff_t>(m_buffer_start),
+    m_buffer.begin() + static_cast<std::ptrdiff_t>(scanned));
+  m_buffer_start = scanned;
+
+  block.text = {block.storage.data(), block.storage.size()};
+  return block;
+}
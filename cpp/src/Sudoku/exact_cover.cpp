@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <utility>
+
+#include "exact_cover.hpp"
+#include "peer_tables.hpp"
+#include "search_stats.hpp"
+#include "sudoku.hpp"
+
+namespace {
+constexpr std::size_t root {0};
+constexpr std::size_t first_row_node {1 + exact_cover_solver::column_count};
+
+// row of the exact cover matrix representing digit (bit + 1) in a cell
+constexpr auto matrix_row(const unsigned cell, const unsigned bit) noexcept
+  -> std::size_t
+{
+  return cell * 9 + bit;
+}
+
+constexpr auto first_node_of_row(const std::size_t row) noexcept
+  -> std::size_t
+{
+  return first_row_node + row * 4;
+}
+
+constexpr auto row_of_node(const std::size_t node) noexcept -> std::size_t
+{
+  return (node - first_row_node) / 4;
+}
+
+// column headers of the 4 constraints satisfied by a row,
+// offset by 1 for the root header
+constexpr auto columns_of_row(const std::size_t row) noexcept
+  -> std::array<std::size_t, 4>
+{
+  const std::size_t cell {row / 9};
+  const std::size_t bit {row % 9};
+  const std::size_t cell_row {cell_positions.rows.at(cell)};
+  const std::size_t cell_col {cell_positions.cols.at(cell)};
+  const std::size_t box {cell_positions.boxes.at(cell)};
+
+  return {1 + cell,
+          1 + 81 + cell_row * 9 + bit,
+          1 + 162 + cell_col * 9 + bit,
+          1 + 243 + box * 9 + bit};
+}
+}  // namespace
+
+// lay out the full matrix: every column linked in the header list,
+// and every row linked into its 4 columns
+void exact_cover_solver::link_matrix() noexcept
+{
+  for ( const std::size_t header :
+        std::views::iota(root, first_row_node) ) {
+    const auto idx {static_cast<node_index>(header)};
+    m_left.at(header) = static_cast<node_index>(
+      header == root ? column_count : header - 1);
+    m_right.at(header) = static_cast<node_index>(
+      header == column_count ? root : header + 1);
+    m_up.at(header) = idx;
+    m_down.at(header) = idx;
+    m_column.at(header) = idx;
+    m_size.at(header) = 0;
+  }
+
+  for ( const std::size_t row :
+        std::views::iota(std::size_t {0}, row_count) ) {
+    const std::size_t first {first_node_of_row(row)};
+    const auto columns {columns_of_row(row)};
+
+    for ( const std::size_t i :
+          std::views::iota(std::size_t {0}, std::size_t {4}) ) {
+      const std::size_t node {first + i};
+      const std::size_t column {columns.at(i)};
+
+      // within the row, circular
+      m_left.at(node) = static_cast<node_index>(first + (i + 3) % 4);
+      m_right.at(node) = static_cast<node_index>(first + (i + 1) % 4);
+
+      // append to the bottom of the column
+      const node_index last {m_up.at(column)};
+      m_up.at(node) = last;
+      m_down.at(node) = static_cast<node_index>(column);
+      m_down.at(last) = static_cast<node_index>(node);
+      m_up.at(column) = static_cast<node_index>(node);
+
+      m_column.at(node) = static_cast<node_index>(column);
+      ++m_size.at(column);
+    }
+  }
+
+  m_row_selection_count = 0;
+}
+
+// remove a column from the header list,
+// and every row intersecting it from the other columns of that row
+void exact_cover_solver::cover(const node_index column) noexcept
+{
+  m_left.at(m_right.at(column)) = m_left.at(column);
+  m_right.at(m_left.at(column)) = m_right.at(column);
+
+  for ( node_index i {m_down.at(column)}; i != column; i = m_down.at(i) ) {
+    for ( node_index j {m_right.at(i)}; j != i; j = m_right.at(j) ) {
+      m_up.at(m_down.at(j)) = m_up.at(j);
+      m_down.at(m_up.at(j)) = m_down.at(j);
+      --m_size.at(m_column.at(j));
+    }
+  }
+}
+
+// exact inverse of cover, so links are restored in reverse order
+void exact_cover_solver::uncover(const node_index column) noexcept
+{
+  for ( node_index i {m_up.at(column)}; i != column; i = m_up.at(i) ) {
+    for ( node_index j {m_left.at(i)}; j != i; j = m_left.at(j) ) {
+      ++m_size.at(m_column.at(j));
+      m_up.at(m_down.at(j)) = j;
+      m_down.at(m_up.at(j)) = j;
+    }
+  }
+
+  m_left.at(m_right.at(column)) = column;
+  m_right.at(m_left.at(column)) = column;
+}
+
+// cover the columns of a row other than the column it was chosen from
+void exact_cover_solver::select_row(const node_index node) noexcept
+{
+  for ( node_index j {m_right.at(node)}; j != node; j = m_right.at(j) ) {
+    this->cover(m_column.at(j));
+  }
+}
+
+void exact_cover_solver::deselect_row(const node_index node) noexcept
+{
+  for ( node_index j {m_left.at(node)}; j != node; j = m_left.at(j) ) {
+    this->uncover(m_column.at(j));
+  }
+}
+
+auto exact_cover_solver::search(const std::size_t depth) noexcept -> bool
+{
+  record_stats(m_stats, [this, depth](search_stats& stats) {
+    const std::size_t level {depth - m_first_depth};
+    ++stats.nodes;
+    ++stats.levels.at(level).nodes;
+    stats.max_depth = std::max(stats.max_depth, level);
+  });
+
+  // every constraint satisfied
+  if ( m_right.at(root) == root ) {
+    return true;
+  }
+
+  // branch on the column with the fewest rows remaining
+  node_index column {m_right.at(root)};
+  for ( node_index i {m_right.at(column)}; i != root; i = m_right.at(i) ) {
+    if ( m_size.at(i) < m_size.at(column) ) {
+      column = i;
+    }
+  }
+
+  // constraint which can no longer be satisfied
+  if ( m_size.at(column) == 0 ) {
+    record_stats(m_stats,
+                 [](search_stats& stats) { ++stats.backtracks; });
+    return false;
+  }
+
+  this->cover(column);
+
+  for ( node_index node {m_down.at(column)}; node != column;
+        node = m_down.at(node) ) {
+    m_solution.at(depth) = node;
+    ++m_row_selection_count;
+
+    record_stats(m_stats, [this, depth](search_stats& stats) {
+      ++stats.branches;
+      ++stats.levels.at(depth - m_first_depth).branches;
+    });
+
+    this->select_row(node);
+
+    if ( this->search(depth + 1) ) {
+      return true;
+    }
+
+    this->deselect_row(node);
+  }
+
+  this->uncover(column);
+  return false;
+}
+
+auto exact_cover_solver::solve(Sudoku& sudoku,
+                               search_stats* const stats) noexcept
+  -> std::pair<std::size_t, bool>
+{
+  std::optional<stats_timer> validate_timer {
+    std::in_place, stats, &search_stats::validate_time};
+
+  // gotta be valid, so that no two clues compete for a column
+  if ( ! sudoku.is_valid() ) {
+    return {0, false};
+  }
+
+  this->link_matrix();
+
+  // clues are rows which must be in the cover
+  std::size_t depth {0};
+  for ( const unsigned cell : std::views::iota(0U, 81U) ) {
+    const char value {sudoku.data().at(cell)};
+    if ( value == '_' ) {
+      continue;
+    }
+
+    const auto bit {static_cast<unsigned>(value - '1')};
+    const auto node {
+      static_cast<node_index>(first_node_of_row(matrix_row(cell, bit)))};
+
+    this->cover(m_column.at(node));
+    this->select_row(node);
+    m_solution.at(depth) = node;
+    ++depth;
+  }
+
+  validate_timer.reset();
+
+  m_stats = stats;
+  m_first_depth = depth;
+
+  bool solved {};
+  {
+    const stats_timer timer {stats, &search_stats::branch_time};
+    solved = this->search(depth);
+  }
+
+  m_stats = nullptr;
+
+  if ( ! solved ) {
+    return {m_row_selection_count, false};
+  }
+
+  std::array<char, 81> cells {};
+  for ( const node_index node : m_solution ) {
+    const std::size_t row {row_of_node(node)};
+    cells.at(row / 9) = static_cast<char>('1' + row % 9);
+  }
+
+  const Sudoku solution {cells};
+
+  assert(solution.is_solved());
+  sudoku = solution;
+  return {m_row_selection_count, true};
+}
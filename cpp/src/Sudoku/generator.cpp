@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "generator.hpp"
+#include "peer_tables.hpp"
+#include "reorder_buffer.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+#include "work_stealing_pool.hpp"
+
+auto parse_symmetry(const std::string_view name) noexcept
+  -> std::optional<symmetry>
+{
+  constexpr static std::array<std::pair<std::string_view, symmetry>, 5>
+    names {
+      {{"none", symmetry::none},
+       {"rotational", symmetry::rotational},
+       {"mirror", symmetry::mirror},
+       {"diagonal", symmetry::diagonal},
+       {"dihedral", symmetry::dihedral}}
+  };
+
+  const auto* const found {std::ranges::find(
+    names, name, &std::pair<std::string_view, symmetry>::first)};
+
+  if ( found == names.end() ) {
+    return std::nullopt;
+  }
+
+  return found->second;
+}
+
+namespace {
+// uniform in [0, bound), by rejection rather than through
+// std::uniform_int_distribution, whose output differs between standard
+// libraries, so a seed gives the same puzzles everywhere
+auto random_below(std::mt19937_64& rng, const std::size_t bound) noexcept
+  -> std::size_t
+{
+  assert(bound > 0);
+
+  constexpr std::uint64_t range_end {
+    std::numeric_limits<std::uint64_t>::max()};
+  const std::uint64_t limit {range_end - range_end % bound};
+
+  std::uint64_t value {rng()};
+  while ( value >= limit ) {
+    value = rng();
+  }
+
+  return static_cast<std::size_t>(value % bound);
+}
+
+// Fisher-Yates, for the same reason as random_below
+template <typename T, std::size_t N>
+void shuffle(std::array<T, N>& values,
+             const std::size_t count,
+             std::mt19937_64& rng) noexcept
+{
+  assert(count <= N);
+
+  for ( std::size_t i {count}; i > 1; --i ) {
+    std::swap(values.at(i - 1), values.at(random_below(rng, i)));
+  }
+}
+
+// the cells a symmetry maps one cell onto, the cell itself included
+struct orbit {
+  std::array<std::uint8_t, 8> cells {};
+  std::size_t size {0};
+};
+
+struct orbit_table {
+  std::array<orbit, 81> orbits {};
+  std::size_t size {0};
+};
+
+auto find_orbits(const symmetry pattern) noexcept -> orbit_table
+{
+  using transform = std::pair<unsigned, unsigned> (*)(unsigned, unsigned);
+
+  constexpr static transform identity {
+    [](const unsigned row, const unsigned col) {
+      return std::pair {row, col};
+    }};
+  constexpr static transform half_turn {
+    [](const unsigned row, const unsigned col) {
+      return std::pair {8 - row, 8 - col};
+    }};
+  constexpr static transform quarter_turn {
+    [](const unsigned row, const unsigned col) {
+      return std::pair {col, 8 - row};
+    }};
+  constexpr static transform three_quarter_turn {
+    [](const unsigned row, const unsigned col) {
+      return std::pair {8 - col, row};
+    }};
+  constexpr static transform flip_columns {
+    [](const unsigned row, const unsigned col) {
+      return std::pair {row, 8 - col};
+    }};
+  constexpr static transform flip_rows {
+    [](const unsigned row, const unsigned col) {
+      return std::pair {8 - row, col};
+    }};
+  constexpr static transform transpose {
+    [](const unsigned row, const unsigned col) {
+      return std::pair {col, row};
+    }};
+  constexpr static transform anti_transpose {
+    [](const unsigned row, const unsigned col) {
+      return std::pair {8 - col, 8 - row};
+    }};
+
+  std::array<transform, 8> group {};
+  std::size_t group_size {0};
+
+  const auto add {[&group, &group_size](const transform element) {
+    group.at(group_size++) = element;
+  }};
+
+  add(identity);
+
+  switch ( pattern ) {
+    case symmetry::none:
+      break;
+    case symmetry::rotational:
+      add(half_turn);
+      break;
+    case symmetry::mirror:
+      add(flip_columns);
+      break;
+    case symmetry::diagonal:
+      add(transpose);
+      break;
+    case symmetry::dihedral:
+      add(half_turn);
+      add(quarter_turn);
+      add(three_quarter_turn);
+      add(flip_columns);
+      add(flip_rows);
+      add(transpose);
+      add(anti_transpose);
+      break;
+  }
+
+  orbit_table table {};
+  std::array<bool, 81> seen {};
+
+  for ( unsigned cell {0}; cell < 81; ++cell ) {
+    if ( seen.at(cell) ) {
+      continue;
+    }
+
+    orbit& current {table.orbits.at(table.size++)};
+
+    for ( std::size_t i {0}; i < group_size; ++i ) {
+      const auto [row, col] {group.at(i)(cell / 9, cell % 9)};
+      const unsigned image {row * 9 + col};
+
+      if ( ! seen.at(image) ) {
+        seen.at(image) = true;
+        current.cells.at(current.size++) =
+          static_cast<std::uint8_t>(image);
+      }
+    }
+  }
+
+  return table;
+}
+
+// the diagonal boxes share no unit, so each may be filled independently
+// with a random permutation, and the solver completes the rest
+auto random_grid(std::mt19937_64& rng) noexcept -> Sudoku
+{
+  std::array<char, 81> cells {};
+  cells.fill('_');
+
+  for ( const unsigned box : {0U, 4U, 8U} ) {
+    std::array<char, 9> digits {
+      '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    shuffle(digits, digits.size(), rng);
+
+    const auto& box_cells {unit_cells.at(18 + box)};
+    for ( std::size_t i {0}; i < digits.size(); ++i ) {
+      cells.at(box_cells.at(i)) = digits.at(i);
+    }
+  }
+
+  Sudoku grid {cells};
+  [[maybe_unused]] const bool solved {
+    grid
+      .solve(&hidden_single_optimization,
+             &minimum_remaining_values_selection)
+      .second};
+  assert(solved);
+
+  return grid;
+}
+
+auto count_clues(const Sudoku& puzzle) noexcept -> std::size_t
+{
+  return static_cast<std::size_t>(
+    std::ranges::count_if(puzzle.data(), [](const char cell) {
+      return cell != '_';
+    }));
+}
+
+// remove clues from a complete grid, an orbit at a time,
+// as long as the solution stays unique
+auto remove_clues(Sudoku puzzle,
+                  orbit_table orbits,
+                  const std::size_t target_clue_count,
+                  std::mt19937_64& rng) noexcept -> Sudoku
+{
+  shuffle(orbits.orbits, orbits.size, rng);
+
+  std::size_t clue_count {81};
+
+  for ( std::size_t i {0}; i < orbits.size; ++i ) {
+    if ( clue_count <= target_clue_count ) {
+      break;
+    }
+
+    const orbit& current {orbits.orbits.at(i)};
+
+    if ( clue_count - current.size < target_clue_count ) {
+      continue;
+    }
+
+    const auto cell_position {[&current](const std::size_t j) {
+      const unsigned cell {current.cells.at(j)};
+      return index_pair {cell / 9, cell % 9};
+    }};
+
+    std::array<char, 8> removed {};
+    for ( std::size_t j {0}; j < current.size; ++j ) {
+      removed.at(j) = puzzle.data().at(current.cells.at(j));
+      puzzle.set_cell(cell_position(j), '_');
+    }
+
+    const std::size_t solution_count {
+      puzzle
+        .count_solutions(&hidden_single_optimization,
+                         &minimum_remaining_values_selection,
+                         2)
+        .second};
+
+    if ( solution_count == 1 ) {
+      clue_count -= current.size;
+    } else {
+      for ( std::size_t j {0}; j < current.size; ++j ) {
+        puzzle.set_cell(cell_position(j), removed.at(j));
+      }
+    }
+  }
+
+  return puzzle;
+}
+}  // namespace
+
+auto generate_puzzle(std::mt19937_64& rng,
+                     const generator_options& options) -> Sudoku
+{
+  const orbit_table orbits {find_orbits(options.pattern)};
+
+  std::optional<Sudoku> best {};
+  std::size_t best_clue_count {};
+
+  for ( std::size_t attempt {0};
+        attempt < std::max(options.attempt_count, std::size_t {1});
+        ++attempt ) {
+    const Sudoku puzzle {remove_clues(
+      random_grid(rng), orbits, options.target_clue_count, rng)};
+    const std::size_t clue_count {count_clues(puzzle)};
+
+    if ( ! best.has_value() || clue_count < best_clue_count ) {
+      best = puzzle;
+      best_clue_count = clue_count;
+    }
+
+    // without a target, every puzzle is as good as the first
+    if ( options.target_clue_count == 0
+         || best_clue_count <= options.target_clue_count ) {
+      break;
+    }
+  }
+
+  return *best;
+}
+
+namespace {
+// consecutive puzzles made by a worker as one task,
+// and the unit the seed is split over
+constexpr std::size_t chunk_size {64};
+
+struct generation_chunk {
+  std::size_t sequence_number {};
+  std::size_t puzzle_count {};
+};
+}  // namespace
+
+auto generate_batch(std::ostream& out,
+                    const std::size_t puzzle_count,
+                    const std::uint64_t seed,
+                    const generator_options& options,
+                    const std::size_t thread_count) -> generation_report
+{
+  generation_report report {};
+  report.puzzle_count = puzzle_count;
+
+  const auto start_time {std::chrono::steady_clock::now()};
+
+  reorder_buffer buffer {};
+  std::atomic<std::size_t> clue_count {0};
+
+  work_stealing_pool<generation_chunk, std::mt19937_64> pool {
+    thread_count == 0
+      ? std::max(std::size_t {1},
+                 std::size_t {std::thread::hardware_concurrency()})
+      : thread_count,
+    [&buffer, &clue_count, seed, &options](std::mt19937_64& rng,
+                                           generation_chunk& chunk) {
+      // every chunk starts a fresh sequence,
+      // wherever and whenever it is made
+      std::seed_seq chunk_seed {
+        static_cast<std::uint32_t>(seed),
+        static_cast<std::uint32_t>(seed >> 32U),
+        static_cast<std::uint32_t>(chunk.sequence_number),
+        static_cast<std::uint32_t>(chunk.sequence_number >> 32U)};
+      rng.seed(chunk_seed);
+
+      chunk_result result {};
+      result.output.reserve(chunk.puzzle_count * 82);
+      std::size_t chunk_clue_count {0};
+
+      for ( std::size_t i {0}; i < chunk.puzzle_count; ++i ) {
+        const Sudoku puzzle {generate_puzzle(rng, options)};
+        const std::size_t puzzle_clue_count {count_clues(puzzle)};
+
+        chunk_clue_count += puzzle_clue_count;
+        if ( options.target_clue_count != 0
+             && puzzle_clue_count > options.target_clue_count ) {
+          ++result.failure_count;
+        }
+
+        const auto& cells {puzzle.data()};
+        result.output.append(cells.data(), cells.size());
+        result.output.push_back('\n');
+      }
+
+      clue_count.fetch_add(chunk_clue_count, std::memory_order_relaxed);
+      buffer.complete(chunk.sequence_number, std::move(result));
+    }};
+
+  report.thread_count = pool.thread_count();
+
+  // bounds the memory held by the reorder buffer
+  const std::size_t max_chunks_in_flight {pool.thread_count() * 4};
+
+  std::size_t submitted_count {0};
+  for ( std::size_t first {0}; first < puzzle_count; first += chunk_size ) {
+    while ( submitted_count - buffer.written_count()
+            >= max_chunks_in_flight ) {
+      report.missed_target_count += buffer.write_ready(out);
+    }
+
+    pool.submit(
+      {submitted_count, std::min(chunk_size, puzzle_count - first)});
+    ++submitted_count;
+  }
+
+  while ( buffer.written_count() < submitted_count ) {
+    report.missed_target_count += buffer.write_ready(out);
+  }
+
+  out.flush();
+
+  report.clue_count = clue_count.load(std::memory_order_relaxed);
+  report.elapsed = std::chrono::steady_clock::now() - start_time;
+  return report;
+}
@@ -0,0 +1,644 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "batch.hpp"
+#include "corpus_reader.hpp"
+#include "line_writer.hpp"
+#include "packed_corpus.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+namespace {
+constexpr std::size_t clue_map_size {(Sudoku::cell_count + 7) / 8};
+
+constexpr std::array<std::uint32_t, 256> crc_table {[]() {
+  std::array<std::uint32_t, 256> table {};
+
+  for ( std::uint32_t byte {0}; byte < table.size(); ++byte ) {
+    std::uint32_t crc {byte};
+    for ( int bit {0}; bit < 8; ++bit ) {
+      crc = (crc & 1) != 0 ? 0xEDB8'8320 ^ (crc >> 1) : crc >> 1;
+    }
+    table.at(byte) = crc;
+  }
+
+  return table;
+}()};
+
+// continue a CRC-32 over more bytes
+auto update_crc(std::uint32_t crc, const std::string_view bytes) noexcept
+  -> std::uint32_t
+{
+  crc = ~crc;
+  for ( const char byte : bytes ) {
+    crc = crc_table[(crc ^ static_cast<unsigned char>(byte)) & 0xFF]
+        ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+// append width bytes of value, least significant first
+template <typename Bytes>
+void append_le(Bytes& bytes, std::uint64_t value, const std::size_t width)
+{
+  for ( std::size_t i {0}; i < width; ++i ) {
+    bytes.push_back(static_cast<char>(value & 0xFF));
+    value >>= 8;
+  }
+}
+
+auto read_le(const std::string_view bytes,
+             const std::size_t offset,
+             const std::size_t width) noexcept -> std::uint64_t
+{
+  std::uint64_t value {0};
+  for ( std::size_t i {width}; i > 0; --i ) {
+    const auto byte {static_cast<unsigned char>(bytes[offset + i - 1])};
+    value = (value << 8) | byte;
+  }
+  return value;
+}
+
+auto as_view(const std::vector<char>& bytes) noexcept -> std::string_view
+{
+  return {bytes.data(), bytes.size()};
+}
+
+void write_bytes(std::ostream& out, const std::string_view bytes)
+{
+  out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// the digit a cell holds, 0 for an empty one
+auto cell_digit(const char cell) noexcept -> unsigned
+{
+  return cell == '_' ? 0 : Sudoku::digit_index(cell) + 1;
+}
+
+// digits packed two to a byte, the first in the low half
+class nibble_packer
+{
+private:
+
+  std::vector<char>* m_bytes;
+  bool m_half_full {false};
+
+public:
+
+  explicit nibble_packer(std::vector<char>& bytes)
+      : m_bytes {&bytes}
+  { }
+
+  void push(const unsigned digit)
+  {
+    if ( m_half_full ) {
+      m_bytes->back() = static_cast<char>(
+        static_cast<unsigned char>(m_bytes->back()) | (digit << 4));
+    } else {
+      m_bytes->push_back(static_cast<char>(digit));
+    }
+    m_half_full = ! m_half_full;
+  }
+};
+
+class nibble_reader
+{
+private:
+
+  std::string_view m_bytes;
+  std::size_t m_position {0};
+
+public:
+
+  explicit nibble_reader(const std::string_view bytes) noexcept
+      : m_bytes {bytes}
+  { }
+
+  // callers check there are enough digits before reading any
+  auto next() noexcept -> unsigned
+  {
+    const auto byte {
+      static_cast<unsigned char>(m_bytes[m_position / 2])};
+    const unsigned digit {m_position % 2 == 0 ? byte & 0xFU : byte >> 4};
+    ++m_position;
+    return digit;
+  }
+};
+
+// the record of one puzzle, see packed_corpus.hpp
+auto decode_record(const std::string_view record,
+                   const bool with_solutions) noexcept
+  -> std::optional<packed_entry>
+{
+  if ( record.size() < clue_map_size ) {
+    return std::nullopt;
+  }
+
+  const auto is_clue {[&record](const std::size_t cell) {
+    const auto byte {static_cast<unsigned char>(record[cell / 8])};
+    return ((byte >> (cell % 8)) & 1U) != 0;
+  }};
+
+  std::size_t clue_count {0};
+  for ( std::size_t i {0}; i < clue_map_size; ++i ) {
+    clue_count += static_cast<std::size_t>(
+      std::popcount(static_cast<unsigned char>(record[i])));
+  }
+
+  // no bits may be set past the last cell
+  const auto last_byte {
+    static_cast<unsigned char>(record[clue_map_size - 1])};
+  const std::size_t digit_count {with_solutions ? Sudoku::cell_count
+                                                : clue_count};
+
+  if ( (last_byte >> (Sudoku::cell_count % 8)) != 0
+       || record.size() != clue_map_size + (digit_count + 1) / 2 ) {
+    return std::nullopt;
+  }
+
+  nibble_reader digits {record.substr(clue_map_size)};
+
+  std::array<char, Sudoku::cell_count> puzzle {};
+  for ( std::size_t cell {0}; cell < puzzle.size(); ++cell ) {
+    if ( ! is_clue(cell) ) {
+      puzzle.at(cell) = '_';
+      continue;
+    }
+
+    const unsigned digit {digits.next()};
+    if ( digit == 0 || digit > Sudoku::side ) {
+      return std::nullopt;
+    }
+    puzzle.at(cell) = Sudoku::digit_symbol(digit - 1);
+  }
+
+  packed_entry entry {Sudoku {puzzle}, std::nullopt};
+
+  if ( ! with_solutions ) {
+    return entry;
+  }
+
+  // all 0 when no solution was stored
+  std::array<char, Sudoku::cell_count> solution {puzzle};
+  bool is_solved {true};
+
+  for ( std::size_t cell {0}; cell < solution.size(); ++cell ) {
+    if ( is_clue(cell) ) {
+      continue;
+    }
+
+    const unsigned digit {digits.next()};
+    if ( digit > Sudoku::side ) {
+      return std::nullopt;
+    }
+
+    is_solved = is_solved && digit != 0;
+    solution.at(cell) = digit == 0 ? '_' : Sudoku::digit_symbol(digit - 1);
+  }
+
+  if ( is_solved ) {
+    entry.solution = Sudoku {solution};
+  }
+
+  return entry;
+}
+}  // namespace
+
+auto crc32(const std::string_view bytes) noexcept -> std::uint32_t
+{
+  return update_crc(0, bytes);
+}
+
+packed_corpus_writer::packed_corpus_writer(std::ostream& out,
+                                           const bool with_solutions)
+    : m_out {&out}
+    , m_with_solutions {with_solutions}
+{
+  std::vector<char> header {packed_format::magic.begin(),
+                            packed_format::magic.end()};
+  append_le(header, packed_format::version, 2);
+  append_le(header, with_solutions ? packed_format::has_solutions : 0, 2);
+  append_le(header, packed_format::block_capacity, 4);
+
+  write_bytes(*m_out, as_view(header));
+  m_position = header.size();
+
+  m_records.reserve(packed_format::block_capacity
+                    * packed_format::max_record_size);
+  m_offsets.reserve(packed_format::block_capacity);
+}
+
+packed_corpus_writer::~packed_corpus_writer() noexcept
+{
+  // out may throw on a failed write, and the index may fail to allocate
+  try {
+    finish();
+  } catch ( ... ) {
+    // nowhere to report it from here
+  }
+}
+
+void packed_corpus_writer::add(const Sudoku& puzzle,
+                               const std::optional<Sudoku>& solution)
+{
+  const auto& cells {puzzle.data()};
+
+  std::array<char, clue_map_size> clue_map {};
+  for ( std::size_t cell {0}; cell < cells.size(); ++cell ) {
+    if ( cells[cell] != '_' ) {
+      clue_map.at(cell / 8) = static_cast<char>(
+        static_cast<unsigned char>(clue_map.at(cell / 8))
+        | (1U << (cell % 8)));
+    }
+  }
+  m_records.insert(m_records.end(), clue_map.begin(), clue_map.end());
+
+  nibble_packer digits {m_records};
+
+  for ( const char cell : cells ) {
+    if ( cell != '_' ) {
+      digits.push(cell_digit(cell));
+    }
+  }
+
+  if ( m_with_solutions ) {
+    for ( std::size_t cell {0}; cell < cells.size(); ++cell ) {
+      if ( cells[cell] == '_' ) {
+        digits.push(solution.has_value()
+                      ? cell_digit(solution->data()[cell])
+                      : 0);
+      }
+    }
+  }
+
+  m_offsets.push_back(static_cast<std::uint16_t>(m_records.size()));
+  ++m_puzzle_count;
+
+  if ( m_offsets.size() == packed_format::block_capacity ) {
+    write_block();
+  }
+}
+
+void packed_corpus_writer::write_block()
+{
+  if ( m_offsets.empty() ) {
+    return;
+  }
+
+  // the offset of each record's start, then of the end of the last,
+  // counted from the start of the block
+  const std::size_t table_size {(m_offsets.size() + 1) * 2};
+
+  std::vector<char> table {};
+  table.reserve(table_size);
+  append_le(table, table_size, 2);
+  for ( const std::uint16_t end : m_offsets ) {
+    append_le(table, table_size + end, 2);
+  }
+
+  const std::uint32_t checksum {
+    update_crc(crc32(as_view(table)), as_view(m_records))};
+
+  write_bytes(*m_out, as_view(table));
+  write_bytes(*m_out, as_view(m_records));
+
+  const std::size_t size {table.size() + m_records.size()};
+  m_index.push_back(
+    {m_position, static_cast<std::uint32_t>(size), checksum});
+  m_position += size;
+
+  m_records.clear();
+  m_offsets.clear();
+}
+
+void packed_corpus_writer::finish()
+{
+  if ( m_finished ) {
+    return;
+  }
+  m_finished = true;
+
+  write_block();
+
+  std::vector<char> tail {};
+  for ( const auto& [offset, size, checksum] : m_index ) {
+    append_le(tail, offset, 8);
+    append_le(tail, size, 4);
+    append_le(tail, checksum, 4);
+  }
+
+  append_le(tail, m_position, 8);
+  append_le(tail, m_puzzle_count, 8);
+  tail.insert(
+    tail.end(), packed_format::magic.begin(), packed_format::magic.end());
+
+  write_bytes(*m_out, as_view(tail));
+  m_out->flush();
+}
+
+auto packed_corpus::from_bytes(const std::string_view bytes) noexcept
+  -> std::optional<packed_corpus>
+{
+  constexpr std::size_t magic_size {packed_format::magic.size()};
+
+  if ( bytes.size()
+         < packed_format::header_size + packed_format::trailer_size
+       || ! bytes.starts_with(packed_format::magic)
+       || ! bytes.ends_with(packed_format::magic) ) {
+    return std::nullopt;
+  }
+
+  const std::uint64_t version {read_le(bytes, magic_size, 2)};
+  const std::uint64_t flags {read_le(bytes, magic_size + 2, 2)};
+  const std::uint64_t block_capacity {read_le(bytes, magic_size + 4, 4)};
+
+  const std::size_t trailer_start {bytes.size()
+                                   - packed_format::trailer_size};
+  const std::uint64_t index_offset {read_le(bytes, trailer_start, 8)};
+  const std::uint64_t puzzle_count {read_le(bytes, trailer_start + 8, 8)};
+
+  if ( version != packed_format::version
+       || (flags & ~std::uint64_t {packed_format::has_solutions}) != 0
+       || block_capacity == 0 || index_offset < packed_format::header_size
+       || index_offset > trailer_start ) {
+    return std::nullopt;
+  }
+
+  const std::uint64_t block_count {(puzzle_count + block_capacity - 1)
+                                   / block_capacity};
+
+  if ( (trailer_start - index_offset) / packed_format::index_entry_size
+         != block_count
+       || (trailer_start - index_offset) % packed_format::index_entry_size
+            != 0 ) {
+    return std::nullopt;
+  }
+
+  packed_corpus corpus {};
+  corpus.m_bytes = bytes;
+  corpus.m_with_solutions = (flags & packed_format::has_solutions) != 0;
+  corpus.m_block_capacity = block_capacity;
+  corpus.m_puzzle_count = puzzle_count;
+  corpus.m_index =
+    bytes.substr(index_offset, trailer_start - index_offset);
+
+  return corpus;
+}
+
+auto packed_corpus::open(const char* const path)
+  -> std::optional<packed_corpus>
+{
+  const int descriptor {::open(path, O_RDONLY | O_CLOEXEC)};
+
+  if ( descriptor < 0 ) {
+    return std::nullopt;
+  }
+
+  struct stat status {};
+
+  // read from the end first, so it must be a file
+  if ( ::fstat(descriptor, &status) != 0 || ! S_ISREG(status.st_mode)
+       || status.st_size == 0 ) {
+    ::close(descriptor);
+    return std::nullopt;
+  }
+
+  const auto size {static_cast<std::size_t>(status.st_size)};
+  void* const mapping {
+    ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+
+  // the mapping holds its own reference to the file
+  ::close(descriptor);
+
+  if ( mapping == MAP_FAILED ) {
+    return std::nullopt;
+  }
+
+  std::optional<packed_corpus> corpus {
+    from_bytes({static_cast<const char*>(mapping), size})};
+
+  if ( ! corpus.has_value() ) {
+    ::munmap(mapping, size);
+    return std::nullopt;
+  }
+
+  corpus->m_is_mapped = true;
+  return corpus;
+}
+
+packed_corpus::packed_corpus(packed_corpus&& other) noexcept
+    : m_bytes {std::exchange(other.m_bytes, {})}
+    , m_is_mapped {std::exchange(other.m_is_mapped, false)}
+    , m_with_solutions {other.m_with_solutions}
+    , m_block_capacity {other.m_block_capacity}
+    , m_puzzle_count {std::exchange(other.m_puzzle_count, 0)}
+    , m_index {std::exchange(other.m_index, {})}
+{ }
+
+auto packed_corpus::operator=(packed_corpus&& other) noexcept
+  -> packed_corpus&
+{
+  if ( this != &other ) {
+    release();
+
+    m_bytes = std::exchange(other.m_bytes, {});
+    m_is_mapped = std::exchange(other.m_is_mapped, false);
+    m_with_solutions = other.m_with_solutions;
+    m_block_capacity = other.m_block_capacity;
+    m_puzzle_count = std::exchange(other.m_puzzle_count, 0);
+    m_index = std::exchange(other.m_index, {});
+  }
+
+  return *this;
+}
+
+packed_corpus::~packed_corpus()
+{
+  release();
+}
+
+void packed_corpus::release() noexcept
+{
+  if ( m_is_mapped ) {
+    // NOLINTNEXTLINE(*-const-cast)
+    ::munmap(const_cast<char*>(m_bytes.data()), m_bytes.size());
+    m_is_mapped = false;
+  }
+}
+
+auto packed_corpus::block(const std::size_t number) const noexcept
+  -> std::string_view
+{
+  const std::size_t entry {number * packed_format::index_entry_size};
+  const std::uint64_t offset {read_le(m_index, entry, 8)};
+  const std::uint64_t size {read_le(m_index, entry + 8, 4)};
+
+  const std::size_t index_offset {
+    static_cast<std::size_t>(m_index.data() - m_bytes.data())};
+
+  if ( offset < packed_format::header_size || offset > index_offset
+       || size > index_offset - offset ) {
+    return {};
+  }
+
+  return m_bytes.substr(offset, size);
+}
+
+auto packed_corpus::verify_block(const std::size_t number) const noexcept
+  -> bool
+{
+  if ( number >= block_count() ) {
+    return false;
+  }
+
+  const std::string_view bytes {block(number)};
+  const std::uint64_t checksum {read_le(
+    m_index, number * packed_format::index_entry_size + 12, 4)};
+
+  return ! bytes.empty() && crc32(bytes) == checksum;
+}
+
+auto packed_corpus::at(const std::size_t number) const noexcept
+  -> std::optional<packed_entry>
+{
+  if ( number >= m_puzzle_count ) {
+    return std::nullopt;
+  }
+
+  const std::size_t block_number {number / m_block_capacity};
+  const std::size_t position {number % m_block_capacity};
+
+  const std::string_view bytes {block(block_number)};
+  const std::size_t record_count {std::min(
+    m_block_capacity, m_puzzle_count - block_number * m_block_capacity)};
+  const std::size_t table_size {(record_count + 1) * 2};
+
+  if ( bytes.size() < table_size ) {
+    return std::nullopt;
+  }
+
+  const std::uint64_t start {read_le(bytes, position * 2, 2)};
+  const std::uint64_t end {read_le(bytes, position * 2 + 2, 2)};
+
+  if ( start < table_size || start > end || end > bytes.size() ) {
+    return std::nullopt;
+  }
+
+  return decode_record(bytes.substr(start, end - start), m_with_solutions);
+}
+
+auto pack_corpus(corpus_reader& in,
+                 std::ostream& out,
+                 const search_strategy* const strategy) -> batch_report
+{
+  // lines read at a time
+  constexpr std::size_t block_size {4096};
+
+  batch_report report {};
+  solver_context context {};
+
+  const auto start_time {std::chrono::steady_clock::now()};
+
+  packed_corpus_writer writer {out, strategy != nullptr};
+
+  for ( corpus_block block {in.next_block(block_size)};
+        ! block.text.empty();
+        block = in.next_block(block_size) ) {
+    report.puzzle_count += block.line_count;
+
+    block.for_each_line([&](const std::string_view line) {
+      const std::optional<Sudoku> puzzle {Sudoku::from_line(line)};
+
+      if ( ! puzzle.has_value() ) {
+        ++report.failure_count;
+        return;
+      }
+
+      std::optional<Sudoku> solution {};
+
+      if ( strategy != nullptr ) {
+        Sudoku board {*puzzle};
+
+        if ( context.solve(board, *strategy).second ) {
+          solution = board;
+        } else {
+          ++report.failure_count;
+        }
+      }
+
+      writer.add(*puzzle, solution);
+    });
+  }
+
+  writer.finish();
+
+  report.elapsed = std::chrono::steady_clock::now() - start_time;
+  return report;
+}
+
+auto unpack_corpus(const packed_corpus& corpus,
+                   std::ostream& out,
+                   const bool with_solutions) -> batch_report
+{
+  batch_report report {.puzzle_count = corpus.size()};
+
+  const auto start_time {std::chrono::steady_clock::now()};
+
+  {
+    line_writer writer {out};
+
+    for ( std::size_t block {0}; block < corpus.block_count(); ++block ) {
+      const std::size_t first {block * corpus.block_capacity()};
+      const std::size_t last {
+        std::min(first + corpus.block_capacity(), corpus.size())};
+
+      if ( ! corpus.verify_block(block) ) {
+        report.failure_count += last - first;
+        continue;
+      }
+
+      for ( std::size_t number {first}; number < last; ++number ) {
+        const std::optional<packed_entry> entry {corpus.at(number)};
+
+        if ( ! entry.has_value() ) {
+          ++report.failure_count;
+          continue;
+        }
+
+        const bool use_solution {with_solutions
+                                 && entry->solution.has_value()};
+        if ( with_solutions && ! use_solution ) {
+          ++report.failure_count;
+        }
+
+        const Sudoku& board {use_solution ? *entry->solution
+                                          : entry->puzzle};
+        const std::string_view prefix {
+          with_solutions && ! use_solution ? batch_failure_prefix : ""};
+
+        writer.write_with(prefix.size() + Sudoku::cell_count + 1,
+                          [&board, prefix](char* line) {
+                            line = std::ranges::copy(prefix, line).out;
+                            *board.format_line(line) = '\n';
+                          });
+      }
+    }
+  }
+
+  report.elapsed = std::chrono::steady_clock::now() - start_time;
+  return report;
+}
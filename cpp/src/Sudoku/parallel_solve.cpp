@@ -0,0 +1,199 @@
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "parallel_solve.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace {
+// subtrees handed out per thread, so that threads finishing
+// a small subtree early have more to pick up
+constexpr std::size_t subtrees_per_thread {8};
+
+// levels of the search tree which may be split into subtrees
+constexpr std::size_t max_split_depth {4};
+
+// Boards of the open nodes at the frontier of a partially expanded
+// search tree, in the order they would be searched,
+// or the solution, if one turned up during expansion
+struct search_frontier {
+  std::vector<Sudoku> boards {};
+  std::optional<Sudoku> solution {};
+  std::size_t assignment_count {};
+};
+
+// expand the subtrees rooted at boards, a level at a time,
+// until there are at least target_count of them
+auto split_search_tree(std::vector<Sudoku> boards,
+                       const optimization_callback_t optimization_callback,
+                       const selection_callback_t selection_callback,
+                       const std::size_t target_count) -> search_frontier
+{
+  search_frontier frontier {std::move(boards)};
+
+  for ( std::size_t depth {0};
+        depth < max_split_depth && frontier.boards.size() < target_count;
+        ++depth ) {
+    std::vector<Sudoku> next_level {};
+
+    for ( const Sudoku& board : frontier.boards ) {
+      solver_state state {board};
+
+      if ( state.has_wipeout() ) {
+        continue;
+      }
+
+      frontier.assignment_count += optimization_callback(state);
+
+      if ( state.has_wipeout() ) {
+        continue;
+      }
+
+      if ( state.is_solved() ) {
+        frontier.solution = state.board();
+        return frontier;
+      }
+
+      const index_pair idxs {selection_callback(state)};
+      const auto legal_assignments {state.domain(idxs)};
+
+      for ( unsigned bit {0}; bit < 9; ++bit ) {
+        if ( ! legal_assignments.test(bit) ) {
+          continue;
+        }
+
+        Sudoku child {state.board()};
+        [[maybe_unused]] const bool success {
+          child.try_assign(idxs, static_cast<char>('1' + bit))};
+        assert(success);
+
+        next_level.push_back(child);
+        ++frontier.assignment_count;
+      }
+    }
+
+    frontier.boards = std::move(next_level);
+  }
+
+  return frontier;
+}
+}  // namespace
+
+auto solve_parallel(Sudoku& sudoku,
+                    const optimization_callback_t optimization_callback,
+                    const selection_callback_t selection_callback,
+                    const std::size_t thread_count,
+                    const std::size_t branch_threshold)
+  -> std::pair<std::size_t, bool>
+{
+  // gotta be valid
+  if ( ! sudoku.is_valid() ) {
+    return {0, false};
+  }
+
+  if ( thread_count <= 1 ) {
+    return sudoku.solve(optimization_callback, selection_callback);
+  }
+
+  // most puzzles are done long before the threshold,
+  // and never pay for starting threads
+  std::size_t sequential_count {};
+  std::vector<Sudoku> open_branches {};
+  {
+    solver_state state {sudoku};
+    basic_search<3> search {state,
+                            optimization_callback,
+                            selection_callback,
+                            {branch_threshold, nullptr}};
+
+    const search_outcome outcome {search.next(sequential_count)};
+
+    if ( outcome == search_outcome::solved ) {
+      sudoku = state.board();
+      return {sequential_count, true};
+    }
+
+    if ( outcome == search_outcome::exhausted ) {
+      return {sequential_count, false};
+    }
+
+    // interrupted, so the branches it had yet to take are split
+    // between the threads, rather than the tree already searched
+    open_branches = search.take_open_branches();
+    sequential_count += open_branches.size();
+  }
+
+  search_frontier frontier {split_search_tree(std::move(open_branches),
+                                              optimization_callback,
+                                              selection_callback,
+                                              thread_count
+                                                * subtrees_per_thread)};
+
+  if ( frontier.solution.has_value() ) {
+    sudoku = *frontier.solution;
+    return {sequential_count + frontier.assignment_count, true};
+  }
+
+  std::atomic<bool> found {false};
+  std::atomic<std::size_t> parallel_count {0};
+  std::mutex solution_mutex {};
+  std::optional<Sudoku> solution {};
+
+  {
+    // nothing needs keeping between subtrees,
+    // each one builds its own solver_state
+    struct no_worker_state { };
+
+    work_stealing_pool<Sudoku, no_worker_state> pool {
+      thread_count,
+      [&](no_worker_state&, Sudoku& subtree) {
+        if ( found.load(std::memory_order_relaxed) ) {
+          return;
+        }
+
+        solver_state state {subtree};
+        std::size_t assignment_count {};
+
+        const search_outcome outcome {
+          depth_first_search(state,
+                             optimization_callback,
+                             selection_callback,
+                             assignment_count,
+                             {.cancelled = &found})};
+
+        parallel_count.fetch_add(assignment_count,
+                                 std::memory_order_relaxed);
+
+        if ( outcome == search_outcome::solved ) {
+          const std::lock_guard lock {solution_mutex};
+          if ( ! solution.has_value() ) {
+            solution = state.board();
+            found.store(true, std::memory_order_relaxed);
+          }
+        }
+      }};
+
+    for ( Sudoku& subtree : frontier.boards ) {
+      pool.submit(std::move(subtree));
+    }
+  }  // pool joins here
+
+  const std::size_t assignment_count {sequential_count
+                                      + frontier.assignment_count
+                                      + parallel_count.load()};
+
+  if ( ! solution.has_value() ) {
+    return {assignment_count, false};
+  }
+
+  assert(solution->is_solved());
+  sudoku = *solution;
+  return {assignment_count, true};
+}
@@ -0,0 +1,553 @@
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+#include "peer_tables.hpp"
+#include "rater.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+auto technique_name(const technique used) noexcept -> std::string_view
+{
+  constexpr static std::array<std::string_view, technique_count> names {
+    "naked single",
+    "hidden single",
+    "locked candidates",
+    "naked pair",
+    "hidden pair",
+    "naked triple",
+    "hidden triple",
+    "naked quad",
+    "hidden quad",
+  };
+
+  return names.at(static_cast<std::size_t>(used));
+}
+
+auto difficulty_tier(const difficulty_rating& rating) noexcept
+  -> std::string_view
+{
+  if ( ! rating.consistent ) {
+    return "invalid";
+  }
+
+  if ( rating.cells_left != 0 ) {
+    return "search";
+  }
+
+  if ( ! rating.hardest.has_value()
+       || *rating.hardest <= technique::hidden_single ) {
+    return "easy";
+  }
+
+  if ( *rating.hardest == technique::locked_candidates ) {
+    return "medium";
+  }
+
+  return "hard";
+}
+
+auto operator<<(std::ostream& out, const difficulty_rating& rhs)
+  -> std::ostream&
+{
+  out << "Difficulty: " << difficulty_tier(rhs) << '\n'
+      << "Hardest technique: "
+      << (rhs.hardest.has_value() ? technique_name(*rhs.hardest)
+                                  : std::string_view {"none"})
+      << '\n';
+
+  for ( std::size_t i {0}; i < technique_count; ++i ) {
+    if ( rhs.uses.at(i) != 0 ) {
+      out << "  " << technique_name(static_cast<technique>(i)) << ": "
+          << rhs.uses.at(i) << '\n';
+    }
+  }
+
+  out << "Cells left for search: " << rhs.cells_left << '\n'
+      << "Search space left: " << rhs.search_space_bits << " bits\n";
+  return out;
+}
+
+namespace {
+using mask_t = solver_state::mask_t;
+
+// unit_cells numbers the units rows, then columns, then boxes
+constexpr unsigned first_col_unit {9};
+constexpr unsigned first_box_unit {18};
+
+auto cell_idxs(const unsigned cell) noexcept -> index_pair
+{
+  return {cell / 9, cell % 9};
+}
+
+auto domain_of(const solver_state& state, const unsigned cell) noexcept
+  -> mask_t
+{
+  return static_cast<mask_t>(state.domain(cell_idxs(cell)).to_ulong());
+}
+
+// strike values from every cell of a unit outside of keep,
+// keep being a set of positions within the unit
+auto eliminate_outside(solver_state& state,
+                       const unsigned unit,
+                       const unsigned keep,
+                       const mask_t values) noexcept -> bool
+{
+  bool progress {false};
+
+  for ( unsigned i {0}; i < 9; ++i ) {
+    if ( (keep & (1U << i)) == 0 ) {
+      progress |=
+        state.eliminate(cell_idxs(unit_cells.at(unit).at(i)), values);
+    }
+  }
+
+  return progress;
+}
+
+// A digit of a box whose cells there all lie on one line
+// is taken from the rest of the line (pointing),
+// and a digit of a line whose cells there all lie in one box
+// is taken from the rest of the box (claiming).
+//
+// Works on the three-cell segments where a box meets a line,
+// applying every pattern found in one pass over them.
+// Each elimination only narrows the domains the segments were taken
+// from, so the patterns found later in the pass still hold.
+//
+// returns the number of patterns which removed anything
+auto apply_locked_candidates(solver_state& state) noexcept
+  -> std::size_t
+{
+  std::size_t applied {0};
+
+  // segments.at(line).at(third) is the union of the domains
+  // of the cells where a line meets its third-th box
+  std::array<std::array<mask_t, 3>, 18> segments {};
+
+  for ( unsigned line {0}; line < 18; ++line ) {
+    for ( unsigned i {0}; i < 9; ++i ) {
+      segments.at(line).at(i / 3) |=
+        domain_of(state, unit_cells.at(line).at(i));
+    }
+  }
+
+  // the positions within a line of its third-th segment,
+  // and the same within a box of a row or column segment
+  constexpr std::array<unsigned, 3> line_segment {0007, 0070, 0700};
+  constexpr std::array<unsigned, 3> box_row {0007, 0070, 0700};
+  constexpr std::array<unsigned, 3> box_col {0111, 0222, 0444};
+
+  for ( unsigned box {0}; box < 9; ++box ) {
+    const unsigned band {box / 3};
+    const unsigned stack {box % 3};
+
+    for ( unsigned i {0}; i < 3; ++i ) {
+      const unsigned row {band * 3 + i};
+      const unsigned col {stack * 3 + i};
+
+      const mask_t row_segment {segments.at(row).at(stack)};
+      const mask_t col_segment {
+        segments.at(first_col_unit + col).at(band)};
+
+      // the same box's other rows and columns
+      mask_t other_rows {};
+      mask_t other_cols {};
+      // the same lines' other boxes
+      mask_t row_elsewhere {};
+      mask_t col_elsewhere {};
+
+      for ( unsigned j {0}; j < 3; ++j ) {
+        if ( j != i ) {
+          other_rows |= segments.at(band * 3 + j).at(stack);
+          other_cols |=
+            segments.at(first_col_unit + stack * 3 + j).at(band);
+        }
+        if ( j != stack ) {
+          row_elsewhere |= segments.at(row).at(j);
+        }
+        if ( j != band ) {
+          col_elsewhere |= segments.at(first_col_unit + col).at(j);
+        }
+      }
+
+      const unsigned box_unit {first_box_unit + box};
+
+      const auto apply {[&state, &applied](const unsigned unit,
+                                           const unsigned keep,
+                                           const mask_t digits) {
+        if ( digits != 0
+             && eliminate_outside(state, unit, keep, digits) ) {
+          ++applied;
+        }
+      }};
+
+      // pointing
+      apply(row,
+            line_segment.at(stack),
+            static_cast<mask_t>(row_segment & ~other_rows));
+      apply(first_col_unit + col,
+            line_segment.at(band),
+            static_cast<mask_t>(col_segment & ~other_cols));
+
+      // claiming
+      apply(box_unit,
+            box_row.at(i),
+            static_cast<mask_t>(row_segment & ~row_elsewhere));
+      apply(box_unit,
+            box_col.at(i),
+            static_cast<mask_t>(col_segment & ~col_elsewhere));
+    }
+  }
+
+  return applied;
+}
+
+// Looks for size of the sets at the positions of candidates
+// whose union has exactly size members,
+// trying them in order, and abandoning any choice whose union has
+// already grown too large
+//
+// found is called with the chosen positions and their union
+// of every subset found
+template <typename Found>
+void find_subset(const std::array<unsigned, 9>& sets,
+                 const unsigned candidates,
+                 const unsigned size,
+                 Found&& found,
+                 const unsigned first = 0,
+                 const unsigned chosen = 0,
+                 const unsigned chosen_union = 0) noexcept
+{
+  const auto chosen_count {static_cast<unsigned>(std::popcount(chosen))};
+
+  for ( unsigned i {first}; i < 9; ++i ) {
+    if ( (candidates & (1U << i)) == 0 ) {
+      continue;
+    }
+
+    const unsigned next_union {chosen_union | sets.at(i)};
+
+    if ( static_cast<unsigned>(std::popcount(next_union)) > size ) {
+      continue;
+    }
+
+    const unsigned next_chosen {chosen | (1U << i)};
+
+    if ( chosen_count + 1 == size ) {
+      found(next_chosen, next_union);
+    } else {
+      find_subset(
+        sets, candidates, size, found, i + 1, next_chosen, next_union);
+    }
+  }
+}
+
+// the set of candidates with between 2 and size members
+auto subset_candidates(const std::array<unsigned, 9>& sets,
+                       const unsigned size) noexcept -> unsigned
+{
+  unsigned candidates {0};
+
+  for ( unsigned i {0}; i < 9; ++i ) {
+    const auto count {static_cast<unsigned>(std::popcount(sets.at(i)))};
+
+    if ( count >= 2 && count <= size ) {
+      candidates |= 1U << i;
+    }
+  }
+
+  return candidates;
+}
+
+// the domains of a unit's cells, and the cells each digit may go in,
+// as positions within the unit
+struct unit_candidates {
+  std::array<unsigned, 9> domains {};
+
+  // digits already placed in the unit have none
+  std::array<unsigned, 9> positions {};
+
+  unsigned open_count {};
+};
+
+using board_candidates = std::array<unit_candidates, 27>;
+
+auto find_unit_candidates(const solver_state& state) noexcept
+  -> board_candidates
+{
+  board_candidates units {};
+
+  for ( unsigned unit {0}; unit < 27; ++unit ) {
+    unit_candidates& current {units.at(unit)};
+
+    for ( unsigned i {0}; i < 9; ++i ) {
+      const mask_t domain {domain_of(state, unit_cells.at(unit).at(i))};
+      current.domains.at(i) = domain;
+
+      if ( domain == 0 ) {
+        continue;
+      }
+
+      ++current.open_count;
+
+      for ( mask_t digits {domain}; digits != 0;
+            digits &= static_cast<mask_t>(digits - 1) ) {
+        current.positions.at(
+          static_cast<unsigned>(std::countr_zero(digits))) |= 1U << i;
+      }
+    }
+  }
+
+  return units;
+}
+
+// size cells of a unit whose domains hold only size digits between them:
+// those digits must go in those cells, so no other cell of the unit
+//
+// every such subset of units is applied,
+// returning the number which removed anything
+auto apply_naked_subset(solver_state& state,
+                        const board_candidates& units,
+                        const unsigned size) noexcept -> std::size_t
+{
+  std::size_t applied {0};
+
+  for ( unsigned unit {0}; unit < 27; ++unit ) {
+    const unit_candidates& current {units.at(unit)};
+
+    // the other open cells hold the other missing digits, a hidden
+    // subset making the same eliminations, so with fewer of them than
+    // size it was already found by a smaller search
+    if ( current.open_count < size * 2 ) {
+      continue;
+    }
+
+    const unsigned candidates {subset_candidates(current.domains, size)};
+
+    if ( static_cast<unsigned>(std::popcount(candidates)) < size ) {
+      continue;
+    }
+
+    find_subset(current.domains,
+                candidates,
+                size,
+                [&state, &applied, unit](const unsigned subset,
+                                         const unsigned digits) {
+                  if ( eliminate_outside(state,
+                                         unit,
+                                         subset,
+                                         static_cast<mask_t>(digits)) ) {
+                    ++applied;
+                  }
+                });
+  }
+
+  return applied;
+}
+
+// size digits of a unit with only size cells between them:
+// those cells must hold those digits, so no other digit
+//
+// likewise applies every one found
+auto apply_hidden_subset(solver_state& state,
+                         const board_candidates& units,
+                         const unsigned size) noexcept -> std::size_t
+{
+  std::size_t applied {0};
+
+  for ( unsigned unit {0}; unit < 27; ++unit ) {
+    const unit_candidates& current {units.at(unit)};
+
+    // likewise the naked subset of the other open cells,
+    // searched for first when it is no larger
+    if ( current.open_count <= size * 2 ) {
+      continue;
+    }
+
+    const unsigned candidates {subset_candidates(current.positions, size)};
+
+    if ( static_cast<unsigned>(std::popcount(candidates)) < size ) {
+      continue;
+    }
+
+    const auto& cells {unit_cells.at(unit)};
+
+    find_subset(current.positions,
+                candidates,
+                size,
+                [&state, &applied, &cells](const unsigned digits,
+                                           const unsigned subset) {
+                  bool progress {false};
+
+                  for ( unsigned i {0}; i < 9; ++i ) {
+                    if ( (subset & (1U << i)) != 0 ) {
+                      progress |= state.eliminate(
+                        cell_idxs(cells.at(i)),
+                        static_cast<mask_t>(~digits));
+                    }
+                  }
+
+                  if ( progress ) {
+                    ++applied;
+                  }
+                });
+  }
+
+  return applied;
+}
+
+// some digit missing from a unit has no cell left to go in
+auto has_stranded_digit(const solver_state& state) noexcept -> bool
+{
+  const auto& masks {state.board().masks()};
+
+  for ( unsigned unit {0}; unit < 27; ++unit ) {
+    mask_t covered {unit < first_col_unit ? masks.rows.at(unit)
+                    : unit < first_box_unit
+                      ? masks.cols.at(unit - first_col_unit)
+                      : masks.boxes.at(unit - first_box_unit)};
+
+    for ( const auto cell : unit_cells.at(unit) ) {
+      covered |= domain_of(state, cell);
+    }
+
+    if ( covered != 0x1FF ) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// apply singles until they are stuck, then the easiest harder technique
+// which makes any progress, returning the hardest one used,
+// or nothing once none of them do
+//
+// Naked singles are applied after each sweep for hidden ones,
+// as in solver_state::apply_singles, so a puzzle singles finish
+// takes no more sweeps to rate than to solve.
+auto apply_easiest(solver_state& state, difficulty_rating& rating) noexcept
+  -> std::optional<technique>
+{
+  const auto count {[&rating](const technique used, std::size_t times) {
+    rating.uses.at(static_cast<std::size_t>(used)) += times;
+  }};
+
+  std::optional<technique> singles {};
+
+  while ( true ) {
+    if ( const std::size_t placed {state.apply_naked_singles()};
+         placed != 0 ) {
+      count(technique::naked_single, placed);
+      singles = singles.value_or(technique::naked_single);
+    }
+
+    if ( state.is_solved() || state.has_wipeout() ) {
+      return singles;
+    }
+
+    const std::size_t placed {state.apply_hidden_singles()};
+
+    if ( placed == 0 ) {
+      break;
+    }
+
+    count(technique::hidden_single, placed);
+    singles = technique::hidden_single;
+  }
+
+  if ( const std::size_t applied {apply_locked_candidates(state)};
+       applied != 0 ) {
+    count(technique::locked_candidates, applied);
+    return technique::locked_candidates;
+  }
+
+  // every subset search sees the same candidates, those of the first
+  // to find anything being no less valid for the ones it removes
+  const board_candidates units {find_unit_candidates(state)};
+
+  // pairs, triples, then quads, each naked before hidden
+  for ( unsigned size {2}; size <= 4; ++size ) {
+    const auto naked {
+      static_cast<technique>(static_cast<unsigned>(technique::naked_pair)
+                             + (size - 2) * 2)};
+
+    if ( const std::size_t applied {
+           apply_naked_subset(state, units, size)};
+         applied != 0 ) {
+      count(naked, applied);
+      return naked;
+    }
+
+    if ( const std::size_t applied {
+           apply_hidden_subset(state, units, size)};
+         applied != 0 ) {
+      const auto hidden {static_cast<technique>(
+        static_cast<unsigned>(naked) + 1)};
+      count(hidden, applied);
+      return hidden;
+    }
+  }
+
+  return singles;
+}
+}  // namespace
+
+auto rate(const Sudoku& puzzle) noexcept -> difficulty_rating
+{
+  if ( ! puzzle.is_valid() ) {
+    return difficulty_rating {.consistent = false};
+  }
+
+  solver_state state {puzzle};
+  return rate(state);
+}
+
+auto rate(solver_state& state) noexcept -> difficulty_rating
+{
+  difficulty_rating rating {};
+
+  while ( ! state.is_solved() && ! state.has_wipeout() ) {
+    const std::optional<technique> used {apply_easiest(state, rating)};
+
+    if ( ! used.has_value() ) {
+      break;
+    }
+
+    if ( ! rating.hardest.has_value() || *used > *rating.hardest ) {
+      rating.hardest = used;
+    }
+  }
+
+  // every assignment was legal, so a full board is consistent,
+  // and has nothing left to search
+  if ( state.is_solved() ) {
+    return rating;
+  }
+
+  if ( state.has_wipeout() || has_stranded_digit(state) ) {
+    rating.consistent = false;
+    return rating;
+  }
+
+  // at most 9^81, well within a double
+  double search_space {1};
+
+  for ( unsigned cell {0}; cell < 81; ++cell ) {
+    if ( state.board().data().at(cell) == '_' ) {
+      ++rating.cells_left;
+      search_space *=
+        static_cast<double>(std::popcount(domain_of(state, cell)));
+    }
+  }
+
+  rating.search_space_bits = std::log2(search_space);
+
+  return rating;
+}
@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "run_record.hpp"
+#include "search_stats.hpp"
+
+namespace {
+
+// seconds to exactly nine decimal places, whatever the stream's settings
+void write_seconds(std::ostream& out, const std::chrono::nanoseconds time)
+{
+  constexpr long long nanoseconds_per_second {1'000'000'000};
+  const long long count {time.count()};
+
+  const char fill {out.fill('0')};
+  out << count / nanoseconds_per_second << '.' << std::setw(9)
+      << count % nanoseconds_per_second;
+  out.fill(fill);
+}
+
+void write_json_string(std::ostream& out, const std::string_view text)
+{
+  constexpr std::string_view hex_digits {"0123456789abcdef"};
+
+  out << '"';
+  for ( const char symbol : text ) {
+    if ( symbol == '"' || symbol == '\\' ) {
+      out << '\\' << symbol;
+    } else if ( static_cast<unsigned char>(symbol) < 0x20 ) {
+      const auto code {static_cast<unsigned char>(symbol)};
+      out << "\\u00" << hex_digits[code >> 4U] << hex_digits[code & 0xFU];
+    } else {
+      out << symbol;
+    }
+  }
+  out << '"';
+}
+
+// quoted only if it has to be, as hyperfine does
+void write_csv_field(std::ostream& out, const std::string_view text)
+{
+  if ( text.find_first_of(",\"\r\n") == std::string_view::npos ) {
+    out << text;
+    return;
+  }
+
+  out << '"';
+  for ( const char symbol : text ) {
+    if ( symbol == '"' ) {
+      out << '"';
+    }
+    out << symbol;
+  }
+  out << '"';
+}
+
+}  // namespace
+
+auto puzzle_name(const std::string_view path) -> std::string
+{
+  const std::size_t slash {path.find_last_of('/')};
+  std::string_view name {
+    slash == std::string_view::npos ? path : path.substr(slash + 1)};
+
+  const std::size_t dot {name.find_last_of('.')};
+  if ( dot != std::string_view::npos && dot != 0 ) {
+    name = name.substr(0, dot);
+  }
+
+  return std::string {name};
+}
+
+void write_json(std::ostream& out, const run_record& record)
+{
+  out << "{\n  \"results\": [\n    {\n      \"command\": ";
+  write_json_string(out, record.command);
+
+  // a single run has no spread, so stddev is null, as hyperfine has it
+  out << ",\n      \"mean\": ";
+  write_seconds(out, record.elapsed);
+  out << ",\n      \"stddev\": null,\n      \"median\": ";
+  write_seconds(out, record.elapsed);
+  out << ",\n      \"user\": ";
+  write_seconds(out, record.user_time);
+  out << ",\n      \"system\": ";
+  write_seconds(out, record.system_time);
+  out << ",\n      \"min\": ";
+  write_seconds(out, record.elapsed);
+  out << ",\n      \"max\": ";
+  write_seconds(out, record.elapsed);
+
+  out << ",\n      \"times\": [";
+  write_seconds(out, record.elapsed);
+  out << "],\n      \"exit_codes\": [0],\n"
+      << "      \"parameters\": {\"alg\": ";
+  write_json_string(out, record.alg);
+  out << ", \"puzzle\": ";
+  write_json_string(out, record.puzzle);
+  out << "},\n      \"input\": ";
+  write_json_string(out, record.input_path);
+
+  out << ",\n      \"time_ns\": " << record.elapsed.count()
+      << ",\n      \"solved\": " << (record.solved ? "true" : "false")
+      << ",\n      \"assignments\": " << record.assignment_count
+      << ",\n      \"solution\": ";
+  if ( record.solved ) {
+    write_json_string(out, record.solution);
+  } else {
+    out << "null";
+  }
+
+  out << ",\n      \"stats\": ";
+  if ( record.stats.has_value() ) {
+    write_json(out, *record.stats);
+  } else {
+    out << "null";
+  }
+
+  out << "\n    }\n  ]\n}\n";
+}
+
+void write_csv_header(std::ostream& out)
+{
+  out << "command,mean,stddev,median,user,system,min,max,"
+         "parameter_alg,parameter_puzzle,"
+         "input,time_ns,solved,assignments,solution,"
+         "nodes,branches,backtracks,naked_singles,hidden_singles,"
+         "max_depth,validate_ns,propagate_ns,branch_ns\n";
+}
+
+void write_csv(std::ostream& out, const run_record& record)
+{
+  write_csv_field(out, record.command);
+  out << ',';
+  write_seconds(out, record.elapsed);
+  // no stddev for a single run
+  out << ",,";
+  write_seconds(out, record.elapsed);
+  out << ',';
+  write_seconds(out, record.user_time);
+  out << ',';
+  write_seconds(out, record.system_time);
+  out << ',';
+  write_seconds(out, record.elapsed);
+  out << ',';
+  write_seconds(out, record.elapsed);
+  out << ',';
+  write_csv_field(out, record.alg);
+  out << ',';
+  write_csv_field(out, record.puzzle);
+  out << ',';
+  write_csv_field(out, record.input_path);
+
+  out << ',' << record.elapsed.count() << ','
+      << (record.solved ? "true" : "false") << ','
+      << record.assignment_count << ',' << record.solution;
+
+  if ( record.stats.has_value() ) {
+    const search_stats& stats {*record.stats};
+    out << ',' << stats.nodes << ',' << stats.branches << ','
+        << stats.backtracks << ',' << stats.naked_singles << ','
+        << stats.hidden_singles << ',' << stats.max_depth << ',';
+
+    if ( stats.time_phases ) {
+      out << stats.validate_time.count() << ','
+          << stats.propagate_time.count() << ','
+          << stats.branch_time.count();
+    } else {
+      out << ",,";
+    }
+  } else {
+    out << ",,,,,,,,,";
+  }
+
+  out << '\n';
+}
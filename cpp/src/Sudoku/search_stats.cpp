@@ -0,0 +1,58 @@
+#include <cstddef>
+#include <iostream>
+#include <ranges>
+
+#include "search_stats.hpp"
+
+auto operator<<(std::ostream& out, const search_stats& rhs)
+  -> std::ostream&
+{
+  out << "Nodes: " << rhs.nodes << '\n'
+      << "Branches: " << rhs.branches << '\n'
+      << "Backtracks: " << rhs.backtracks << '\n'
+      << "Forced moves: " << rhs.forced_moves()
+      << " (naked singles: " << rhs.naked_singles
+      << ", hidden singles: " << rhs.hidden_singles << ")\n"
+      << "Maximum depth: " << rhs.max_depth << '\n'
+      << "Validate: " << rhs.validate_time.count() << "ns\n"
+      << "Propagate: " << rhs.propagate_time.count() << "ns\n"
+      << "Branch: " << rhs.branch_time.count() << "ns\n"
+      << "Depth\tNodes\tBranches\n";
+
+  for ( const std::size_t depth :
+        std::views::iota(std::size_t {0}, rhs.max_depth + 1) ) {
+    const search_stats::level& level {rhs.levels.at(depth)};
+    out << depth << '\t' << level.nodes << '\t' << level.branches << '\n';
+  }
+
+  return out;
+}
+
+void write_json(std::ostream& out, const search_stats& stats)
+{
+  out << "{\"nodes\": " << stats.nodes
+      << ", \"branches\": " << stats.branches
+      << ", \"backtracks\": " << stats.backtracks
+      << ", \"forced_moves\": {\"naked_singles\": " << stats.naked_singles
+      << ", \"hidden_singles\": " << stats.hidden_singles << '}'
+      << ", \"max_depth\": " << stats.max_depth << ", \"time_ns\": ";
+
+  if ( stats.time_phases ) {
+    out << "{\"validate\": " << stats.validate_time.count()
+        << ", \"propagate\": " << stats.propagate_time.count()
+        << ", \"branch\": " << stats.branch_time.count() << '}';
+  } else {
+    out << "null";
+  }
+
+  out << ", \"levels\": [";
+
+  for ( const std::size_t depth :
+        std::views::iota(std::size_t {0}, stats.max_depth + 1) ) {
+    const search_stats::level& level {stats.levels.at(depth)};
+    out << (depth == 0 ? "" : ", ") << "{\"nodes\": " << level.nodes
+        << ", \"branches\": " << level.branches << '}';
+  }
+
+  out << "]}";
+}
@@ -1,106 +1,406 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <optional>
 #include <ranges>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "peer_tables.hpp"
+#include "search_stats.hpp"
+#include "solver_state.hpp"
 #include "sudoku.hpp"
 
 template std::string supl::to_string<Sudoku>(const Sudoku&);
 
-auto null_optimization(Sudoku&) -> std::size_t
+template <unsigned BoxSize>
+auto null_optimization(basic_solver_state<BoxSize>&) -> std::size_t
 {
   return 0;
 }
 
-auto trivial_move_optimization(Sudoku& sudoku) -> std::size_t
+template <unsigned BoxSize>
+auto trivial_move_optimization(basic_solver_state<BoxSize>& state)
+  -> std::size_t
 {
-  std::size_t trivial_assignment_count {};
-  while ( sudoku.apply_trivial_move() ) {
-    ++trivial_assignment_count;
-  }
+  return state.apply_naked_singles();
+}
 
-  return trivial_assignment_count;
+template <unsigned BoxSize>
+auto hidden_single_optimization(basic_solver_state<BoxSize>& state)
+  -> std::size_t
+{
+  return state.apply_singles();
 }
 
-auto Sudoku::solve(
-  std::add_pointer_t<std::size_t(Sudoku&)> optimization_callback) noexcept
-  -> std::pair<std::size_t, bool>
+template <unsigned BoxSize>
+auto first_unassigned_selection(const basic_solver_state<BoxSize>& state)
+  -> index_pair
 {
-  std::size_t assignment_count {};
+  constexpr unsigned side {board_shape<BoxSize>::side};
 
-  // gotta be valid
-  if ( ! this->is_valid() ) {
-    return {0, false};
-  }
+  const auto& cells {state.board().data()};
+  const auto first_unassigned_cell {
+    static_cast<unsigned>(std::ranges::find(cells, '_') - cells.begin())};
 
-  // gotta have legal assignments
-  if ( ! this->has_legal_assignments() ) {
-    return {0, false};
+  assert(first_unassigned_cell < cells.size());
+
+  return {first_unassigned_cell / side, first_unassigned_cell % side};
+}
+
+// number of unassigned cells sharing a row, column, or box with idxs
+template <unsigned BoxSize>
+static auto degree(const basic_sudoku<BoxSize>& board,
+                   const index_pair idxs) noexcept -> unsigned
+{
+  using geometry = board_geometry<BoxSize>;
+  const auto& cells {board.data()};
+
+  return static_cast<unsigned>(std::ranges::count_if(
+    geometry::peers.at(idxs.row * geometry::side + idxs.col),
+    [&cells](const auto peer) { return cells.at(peer) == '_'; }));
+}
+
+// fail-first: the cell with the fewest legal assignments,
+// ties broken by the most unassigned peers (most constraining)
+template <unsigned BoxSize>
+auto minimum_remaining_values_selection(
+  const basic_solver_state<BoxSize>& state) -> index_pair
+{
+  constexpr unsigned side {board_shape<BoxSize>::side};
+  const auto board_view {state.board().mdview()};
+
+  index_pair best {};
+  std::size_t best_count {side + 1};
+  unsigned best_degree {};
+
+  for ( const unsigned row : std::views::iota(0U, side) ) {
+    for ( const unsigned col : std::views::iota(0U, side) ) {
+      if ( board_view(row, col) != '_' ) {
+        continue;
+      }
+
+      const std::size_t count {state.domain({row, col}).count()};
+
+      if ( count > best_count ) {
+        continue;
+      }
+
+      const unsigned cell_degree {degree(state.board(), {row, col})};
+
+      if ( count < best_count || cell_degree > best_degree ) {
+        best = {row, col};
+        best_count = count;
+        best_degree = cell_degree;
+      }
+    }
   }
 
-  // apply any trivial moves available
-  assignment_count += optimization_callback(*this);
+  assert(best_count <= side);
+
+  return best;
+}
 
-  if ( this->is_solved() ) {
-    return {assignment_count, true};
+template <unsigned BoxSize>
+auto basic_search<BoxSize>::next(std::size_t& assignment_count) noexcept
+  -> search_outcome
+{
+  if ( m_exhausted ) {
+    return search_outcome::exhausted;
   }
 
-  const std::array<variable_domain, 81> all_domains {
-    this->query_domains()};
+  if ( m_at_solution ) {
+    m_state.undo(m_solution_point);
+    m_at_solution = false;
+    m_expand = false;
+  }
 
-  const variable_domain first_unassigned_variable {*std::ranges::find_if(
-    all_domains, [](const variable_domain& domain) -> bool {
-      return domain.value == '_';
-    })};
+  // the search runs on locals, which the trail writes into state
+  // cannot alias, and is saved back to the members when it pauses
+  std::size_t depth {m_depth};
+  std::size_t branch_count {m_branch_count};
+  std::size_t assignments {0};
+  bool expand {m_expand};
 
-  // better be a variable with legal assignments!
-  // (should be checked above)
-  assert(first_unassigned_variable.legal_assignments.any());
+  const auto pause {[&](const search_outcome outcome) {
+    m_depth = depth;
+    m_branch_count = branch_count;
+    m_expand = expand;
+    assignment_count += assignments;
+    return outcome;
+  }};
 
-  const std::vector<Assignment> possible_assignments {
-    [&first_unassigned_variable]() -> std::vector<Assignment> {
-      std::vector<Assignment> retval {};
+  while ( true ) {
+    // expand the current node
+    if ( expand ) {
+      if ( m_limits.cancelled != nullptr
+           && m_limits.cancelled->load(std::memory_order_relaxed) ) {
+        return pause(search_outcome::interrupted);
+      }
 
-      for ( const unsigned long bit : std::views::iota(0UL, 9UL) ) {
+      record_stats(m_stats, [depth](search_stats& stats) {
+        ++stats.nodes;
+        ++stats.levels.at(depth).nodes;
+        stats.max_depth = std::max(stats.max_depth, depth);
+      });
 
-        if ( first_unassigned_variable.legal_assignments.test(bit) ) {
+      // gotta have legal assignments
+      if ( m_state.has_wipeout() ) {
+        record_stats(m_stats,
+                     [](search_stats& stats) { ++stats.backtracks; });
+      } else {
+        const typename state_t::checkpoint entry_point {m_state.mark()};
+
+        // apply any trivial moves available
+        {
+          const stats_timer timer {m_stats,
+                                   &search_stats::propagate_time};
+          assignments += m_optimization_callback(m_state);
+        }
 
-          const char value {static_cast<char>(bit + '0' + 1)};
+        if ( m_state.has_wipeout() ) {
+          record_stats(m_stats,
+                       [](search_stats& stats) { ++stats.backtracks; });
+          m_state.undo(entry_point);
+        } else if ( m_state.is_solved() ) {
+          m_at_solution = true;
+          m_solution_point = entry_point;
+          return pause(search_outcome::solved);
+        } else {
+          const stats_timer timer {m_stats, &search_stats::branch_time};
+          const index_pair idxs {m_selection_callback(m_state)};
+          const auto legal_assignments {
+            static_cast<mask_t>(m_state.domain(idxs).to_ulong())};
 
-          assert(value >= '1');
-          assert(value <= '9');
+          // better be a variable with legal assignments!
+          // (no wipeout, checked above)
+          assert(legal_assignments != 0);
+          assert(depth < m_stack.size());
 
-          retval.emplace_back(first_unassigned_variable.idxs, value);
+          m_stack.at(depth) = {
+            entry_point, m_state.mark(), idxs, legal_assignments};
+          ++depth;
         }
       }
+    }
+
+    expand = true;
+
+    // unwind exhausted levels
+    while ( depth > 0 && m_stack.at(depth - 1).untried == 0 ) {
+      --depth;
+      m_state.undo(m_stack.at(depth).entry_point);
+    }
+
+    if ( depth == 0 ) {
+      m_exhausted = true;
+      return pause(search_outcome::exhausted);
+    }
+
+    if ( branch_count == m_limits.max_branch_count ) {
+      // pick up at the branch not yet taken
+      expand = false;
+      return pause(search_outcome::interrupted);
+    }
+    ++branch_count;
+
+    record_stats(m_stats, [depth](search_stats& stats) {
+      ++stats.branches;
+      ++stats.levels.at(depth - 1).branches;
+    });
+
+    // take the next branch of the deepest open level
+    const stats_timer timer {m_stats, &search_stats::branch_time};
+    frame& top {m_stack.at(depth - 1)};
+    m_state.undo(top.branch_point);
+
+    const auto bit {static_cast<unsigned>(std::countr_zero(top.untried))};
+    top.untried &= static_cast<mask_t>(top.untried - 1);
 
-      return retval;
-    }()};  // Immediately Invoked Lambda Expression
+    const char value {basic_sudoku<BoxSize>::digit_symbol(bit)};
 
-  for ( const Assignment& assignment : possible_assignments ) {
-    Sudoku next {this->assign_copy(assignment)};
-    ++assignment_count;
+    m_state.assign({top.idxs, value});
+    ++assignments;
+  }
+}
+
+template <unsigned BoxSize>
+auto basic_search<BoxSize>::take_open_branches()
+  -> std::vector<basic_sudoku<BoxSize>>
+{
+  if ( m_at_solution ) {
+    m_state.undo(m_solution_point);
+    m_at_solution = false;
+  }
+
+  std::vector<basic_sudoku<BoxSize>> branches {};
 
-    if ( next.is_solved() ) {  // yay!
-      *this = next;
-      return {assignment_count, true};
+  for ( ; m_depth > 0; --m_depth ) {
+    frame& level {m_stack.at(m_depth - 1)};
+    m_state.undo(level.branch_point);
+
+    for ( ; level.untried != 0;
+          level.untried &= static_cast<mask_t>(level.untried - 1) ) {
+      const auto bit {
+        static_cast<unsigned>(std::countr_zero(level.untried))};
+
+      basic_sudoku<BoxSize> branch {m_state.board()};
+      [[maybe_unused]] const bool success {branch.try_assign(
+        level.idxs, basic_sudoku<BoxSize>::digit_symbol(bit))};
+      assert(success);
+
+      branches.push_back(branch);
     }
 
-    const auto [increased_count,
-                is_solved] {next.solve(optimization_callback)};
-    assignment_count += increased_count;
+    m_state.undo(level.entry_point);
+  }
+
+  m_exhausted = true;
+  return branches;
+}
 
-    if ( is_solved ) {
-      assert(next.is_solved());
-      *this = next;
-      return {assignment_count, true};
+template <unsigned BoxSize>
+auto depth_first_search(
+  basic_solver_state<BoxSize>& state,
+  const basic_optimization_callback_t<BoxSize> optimization_callback,
+  const basic_selection_callback_t<BoxSize> selection_callback,
+  std::size_t& assignment_count,
+  const search_limits& limits) noexcept -> search_outcome
+{
+  return basic_search<BoxSize> {
+    state, optimization_callback, selection_callback, limits}
+    .next(assignment_count);
+}
+
+template <unsigned BoxSize>
+auto count_solutions(
+  basic_solver_state<BoxSize>& state,
+  const basic_optimization_callback_t<BoxSize> optimization_callback,
+  const basic_selection_callback_t<BoxSize> selection_callback,
+  std::size_t& assignment_count,
+  const std::size_t solution_limit) noexcept -> std::size_t
+{
+  const typename basic_solver_state<BoxSize>::checkpoint start {
+    state.mark()};
+  basic_search<BoxSize> search {
+    state, optimization_callback, selection_callback};
+  std::size_t solution_count {0};
+
+  while ( search.next(assignment_count) == search_outcome::solved ) {
+    ++solution_count;
+
+    if ( solution_count == solution_limit ) {
+      // still holding the last solution
+      state.undo(start);
+      break;
     }
   }
 
-  return {assignment_count, false};
+  return solution_count;
 }
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::solve(
+  const basic_optimization_callback_t<BoxSize> optimization_callback,
+  const basic_selection_callback_t<BoxSize> selection_callback,
+  search_stats* const stats) noexcept -> std::pair<std::size_t, bool>
+{
+  std::optional<stats_timer> validate_timer {
+    std::in_place, stats, &search_stats::validate_time};
+
+  // gotta be valid
+  if ( ! this->is_valid() ) {
+    return {0, false};
+  }
+
+  std::size_t assignment_count {};
+  basic_solver_state<BoxSize> state {*this};
+
+  validate_timer.reset();
+
+  if ( basic_search<BoxSize> {state,
+                              optimization_callback,
+                              selection_callback,
+                              {},
+                              stats}
+         .next(assignment_count)
+       != search_outcome::solved ) {
+    return {assignment_count, false};
+  }
+
+  assert(state.board().is_solved());
+  *this = state.board();
+  return {assignment_count, true};
+}
+
+template <unsigned BoxSize>
+auto basic_sudoku<BoxSize>::count_solutions(
+  const basic_optimization_callback_t<BoxSize> optimization_callback,
+  const basic_selection_callback_t<BoxSize> selection_callback,
+  const std::size_t solution_limit) const noexcept
+  -> std::pair<std::size_t, std::size_t>
+{
+  if ( ! this->is_valid() ) {
+    return {0, 0};
+  }
+
+  std::size_t assignment_count {};
+  basic_solver_state<BoxSize> state {*this};
+
+  // the free function, not this member
+  const std::size_t solution_count {::count_solutions(state,
+                                                      optimization_callback,
+                                                      selection_callback,
+                                                      assignment_count,
+                                                      solution_limit)};
+
+  return {assignment_count, solution_count};
+}
+
+// every supported board size
+
+#define INSTANTIATE_SOLVE(box_size)                                       \
+  template class basic_search<box_size>;                                  \
+  template auto null_optimization(basic_solver_state<box_size>&)          \
+    -> std::size_t;                                                       \
+  template auto trivial_move_optimization(basic_solver_state<box_size>&)  \
+    -> std::size_t;                                                       \
+  template auto hidden_single_optimization(basic_solver_state<box_size>&) \
+    -> std::size_t;                                                       \
+  template auto first_unassigned_selection(                               \
+    const basic_solver_state<box_size>&) -> index_pair;                   \
+  template auto minimum_remaining_values_selection(                       \
+    const basic_solver_state<box_size>&) -> index_pair;                   \
+  template auto depth_first_search(                                       \
+    basic_solver_state<box_size>&,                                        \
+    basic_optimization_callback_t<box_size>,                              \
+    basic_selection_callback_t<box_size>,                                 \
+    std::size_t&,                                                         \
+    const search_limits&) noexcept -> search_outcome;                     \
+  template auto count_solutions(                                          \
+    basic_solver_state<box_size>&,                                        \
+    basic_optimization_callback_t<box_size>,                              \
+    basic_selection_callback_t<box_size>,                                 \
+    std::size_t&,                                                         \
+    std::size_t) noexcept -> std::size_t;                                 \
+  template auto basic_sudoku<box_size>::solve(                            \
+    basic_optimization_callback_t<box_size>,                              \
+    basic_selection_callback_t<box_size>,                                 \
+    search_stats*) noexcept -> std::pair<std::size_t, bool>;              \
+  template auto basic_sudoku<box_size>::count_solutions(                  \
+    basic_optimization_callback_t<box_size>,                              \
+    basic_selection_callback_t<box_size>,                                 \
+    std::size_t) const noexcept -> std::pair<std::size_t, std::size_t>;
+
+INSTANTIATE_SOLVE(2)
+INSTANTIATE_SOLVE(3)
+INSTANTIATE_SOLVE(4)
+INSTANTIATE_SOLVE(5)
+
+#undef INSTANTIATE_SOLVE
@@ -0,0 +1,243 @@
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <utility>
+
+#include "peer_tables.hpp"
+#include "search_stats.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+template <unsigned BoxSize>
+basic_solver_state<BoxSize>::basic_solver_state(
+  const board_t& board) noexcept
+    : m_board {board}
+{
+  assert(m_board.is_valid());
+
+  m_domains = m_board.all_candidates();
+
+  for ( const unsigned cell :
+        std::views::iota(0U, geometry::cell_count) ) {
+    if ( std::as_const(m_board).data().at(cell) == '_'
+         && m_domains.at(cell) == 0 ) {
+      ++m_wipeout_count;
+    }
+  }
+}
+
+template <unsigned BoxSize>
+void basic_solver_state<BoxSize>::strike(const unsigned cell,
+                                         const mask_t bit) noexcept
+{
+  mask_t& domain {m_domains.at(cell)};
+
+  if ( (domain & bit) == 0 ) {
+    return;
+  }
+
+  domain &= static_cast<mask_t>(~bit);
+  this->push_trail({static_cast<cell_index_t>(cell), false, bit});
+
+  // populated cells already have empty domains, so this was a live cell
+  if ( domain == 0 ) {
+    ++m_wipeout_count;
+  }
+}
+
+template <unsigned BoxSize>
+void basic_solver_state<BoxSize>::assign(
+  const Assignment assignment) noexcept
+{
+  const auto [row, col] {assignment.idxs};
+  const unsigned cell {row * geometry::side + col};
+  const auto bit {static_cast<mask_t>(
+    1U << board_t::digit_index(assignment.value))};
+
+  assert((m_domains.at(cell) & bit) != 0);
+
+  [[maybe_unused]] const bool success {m_board.try_assign(assignment)};
+  assert(success);
+
+  this->push_trail(
+    {static_cast<cell_index_t>(cell), true, m_domains.at(cell)});
+  m_domains.at(cell) = 0;
+
+  for ( const cell_index_t peer : geometry::peers.at(cell) ) {
+    this->strike(peer, bit);
+  }
+}
+
+template <unsigned BoxSize>
+auto basic_solver_state<BoxSize>::eliminate(const index_pair idxs,
+                                            const mask_t values) noexcept
+  -> bool
+{
+  const unsigned cell {idxs.row * geometry::side + idxs.col};
+  mask_t& domain {m_domains.at(cell)};
+
+  // only what is actually removed goes on the trail,
+  // so that undo() restores exactly the domain found here
+  const auto removed {static_cast<mask_t>(domain & values)};
+
+  if ( removed == 0 ) {
+    return false;
+  }
+
+  domain &= static_cast<mask_t>(~removed);
+  this->push_trail({static_cast<cell_index_t>(cell), false, removed});
+
+  if ( domain == 0 ) {
+    ++m_wipeout_count;
+  }
+
+  return true;
+}
+
+template <unsigned BoxSize>
+void basic_solver_state<BoxSize>::undo(const checkpoint point) noexcept
+{
+  assert(point <= m_trail_size);
+
+  while ( m_trail_size > point ) {
+    --m_trail_size;
+    const trail_entry entry {m_trail.at(m_trail_size)};
+
+    mask_t& domain {m_domains.at(entry.cell)};
+
+    if ( entry.is_assignment ) {
+      m_board.unassign({entry.cell / geometry::side,
+                        entry.cell % geometry::side});
+    } else if ( domain == 0 ) {
+      --m_wipeout_count;
+    }
+
+    domain |= entry.removed;
+  }
+}
+
+template <unsigned BoxSize>
+auto basic_solver_state<BoxSize>::apply_naked_singles() noexcept
+  -> std::size_t
+{
+  std::size_t assignment_count {};
+
+  // each sweep sees the domains as reduced by the assignments before it
+  for ( bool progress {true}; progress && ! this->has_wipeout(); ) {
+    progress = false;
+
+    for ( const unsigned cell :
+          std::views::iota(0U, geometry::cell_count) ) {
+      const mask_t domain {m_domains.at(cell)};
+
+      if ( ! std::has_single_bit(domain) ) {
+        continue;
+      }
+
+      const auto value {board_t::digit_symbol(
+        static_cast<unsigned>(std::countr_zero(domain)))};
+      this->assign({
+        {cell / geometry::side, cell % geometry::side},
+        value
+      });
+      ++assignment_count;
+      progress = true;
+
+      if ( this->has_wipeout() ) {
+        break;
+      }
+    }
+  }
+
+  record_stats(m_stats, [assignment_count](search_stats& stats) {
+    stats.naked_singles += assignment_count;
+  });
+
+  return assignment_count;
+}
+
+template <unsigned BoxSize>
+auto basic_solver_state<BoxSize>::apply_hidden_singles() noexcept
+  -> std::size_t
+{
+  std::size_t assignment_count {};
+
+  for ( const auto& unit : geometry::units ) {
+    // digits legal in at least one, and in at least two, cells of the unit
+    // populated cells have empty domains,
+    // so digits already placed in the unit appear in neither
+    mask_t seen_once {};
+    mask_t seen_twice {};
+
+    for ( const cell_index_t cell : unit ) {
+      const mask_t domain {m_domains.at(cell)};
+      seen_twice |= static_cast<mask_t>(seen_once & domain);
+      seen_once |= domain;
+    }
+
+    auto hidden {static_cast<mask_t>(seen_once & ~seen_twice)};
+
+    while ( hidden != 0 ) {
+      const auto digit {static_cast<unsigned>(std::countr_zero(hidden))};
+      const auto bit {static_cast<mask_t>(1U << digit)};
+      hidden &= static_cast<mask_t>(~bit);
+
+      // an earlier assignment in this unit may have struck the digit
+      // from its only cell, leaving nowhere to put it;
+      // the search will discover that dead end on its own
+      for ( const cell_index_t cell : unit ) {
+        if ( (m_domains.at(cell) & bit) == 0 ) {
+          continue;
+        }
+
+        this->assign({
+          {cell / geometry::side, cell % geometry::side},
+          board_t::digit_symbol(digit)
+        });
+        ++assignment_count;
+        break;
+      }
+
+      if ( this->has_wipeout() ) {
+        break;
+      }
+    }
+
+    if ( this->has_wipeout() ) {
+      break;
+    }
+  }
+
+  record_stats(m_stats, [assignment_count](search_stats& stats) {
+    stats.hidden_singles += assignment_count;
+  });
+
+  return assignment_count;
+}
+
+template <unsigned BoxSize>
+auto basic_solver_state<BoxSize>::apply_singles() noexcept -> std::size_t
+{
+  std::size_t assignment_count {this->apply_naked_singles()};
+
+  while ( ! this->has_wipeout() ) {
+    const std::size_t hidden_count {this->apply_hidden_singles()};
+
+    if ( hidden_count == 0 ) {
+      break;
+    }
+
+    assignment_count += hidden_count;
+    assignment_count += this->apply_naked_singles();
+  }
+
+  return assignment_count;
+}
+
+template class basic_solver_state<2>;
+template class basic_solver_state<3>;
+template class basic_solver_state<4>;
+template class basic_solver_state<5>;
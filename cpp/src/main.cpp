@@ -1,104 +1,905 @@
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <random>
 #include <ranges>
+#include <sstream>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <sys/resource.h>
 
 #include <supl/predicates.hpp>
 
+#include "batch.hpp"
+#include "board_parser.hpp"
+#include "corpus_reader.hpp"
+#include "generator.hpp"
+#include "line_writer.hpp"
+#include "packed_corpus.hpp"
+#include "parallel_solve.hpp"
+#include "rater.hpp"
+#include "run_record.hpp"
+#include "search_stats.hpp"
+#include "solution_generator.hpp"
+#include "strategy.hpp"
 #include "sudoku.hpp"
 
 void print_help_message([[maybe_unused]] const int argc,
                         const char* const* const argv)
 {
   std::cerr << "Usage:\n"
-            << argv[0] << " --simple [input_file.dat]\n"
-            << argv[0] << " --smart [input_file.dat]\n";
+            << argv[0]
+            << " --simple [input_file.dat] [--threads N] [--stats]\n"
+            << argv[0]
+            << " --smart [input_file.dat] [--threads N] [--stats]\n"
+            << argv[0]
+            << " --mrv [input_file.dat] [--threads N] [--stats]\n"
+            << argv[0]
+            << " --hidden [input_file.dat] [--threads N] [--stats]\n"
+            << argv[0] << " --dlx [input_file.dat] [--stats]\n"
+            << argv[0] << " --count [limit] [strategy] [input_file.dat]\n"
+            << argv[0]
+            << " --enumerate [limit] [strategy] [input_file.dat]\n"
+            << argv[0]
+            << " --batch [strategy] [corpus_file.txt] [--threads N]\n"
+            << argv[0]
+            << " --pack [corpus_file.txt] [packed_file] [strategy]\n"
+            << argv[0] << " --unpack [packed_file] [--solutions]\n"
+            << argv[0] << " --rate [input_file.dat]\n"
+            << argv[0]
+            << " --rate-batch [corpus_file.txt] [strategy] [--threads N]\n"
+            << argv[0]
+            << " --generate [count] [--clues N] [--symmetry S] [--seed N]"
+               " [--threads N]\n"
+            << "Symmetries: "
+               "none, rotational, mirror, diagonal, dihedral\n"
+            << "A single puzzle also takes --stats=json,"
+               " --format=json|csv, and --boards\n";
 }
 
-auto main(const int argc, const char* const* const argv) -> int
+// looks up the strategy named by a command line flag,
+// exiting with an explanation if there is no such strategy
+template <unsigned BoxSize = 3>
+static auto parse_strategy(const int argc,
+                           const char* const* const argv,
+                           const char* const flag)
+  -> const basic_search_strategy<BoxSize>&
 {
-  using namespace std::literals;  // for operator""sv string_view literal
+  const auto* const strategy {find_strategy<BoxSize>(flag)};
 
-  for ( const int i : std::views::iota(1, argc) ) {
-    constexpr static auto help_pred {
-      supl::equals_any_of("--help"sv, "-h"sv)};
-    if ( help_pred(argv[i]) ) {
-      print_help_message(argc, argv);
-      return EXIT_SUCCESS;
-    }
+  if ( strategy == nullptr ) {
+    std::cerr << "Bad search strategy: \"" << flag
+              << "\". Must be [--simple], [--smart], [--mrv], "
+                 "[--hidden], or [--dlx].\n";
+    print_help_message(argc, argv);
+    std::exit(EXIT_FAILURE);
   }
 
-  if ( argc != 3 ) {
+  return *strategy;
+}
+
+static auto open_input(const int argc,
+                       const char* const* const argv,
+                       const char* const path) -> std::ifstream
+{
+  std::ifstream infile {path};
+
+  if ( ! infile.is_open() ) {
+    std::cerr << "Error opening file: \"" << path << "\"\n";
     print_help_message(argc, argv);
-    return EXIT_FAILURE;
+    std::exit(EXIT_FAILURE);
   }
 
-  constexpr static auto strategy_pred {
-    supl::equals_any_of("--simple"sv, "--smart"sv, "--just-print"sv)};
-  if ( ! strategy_pred(argv[1]) ) {
-    std::cerr << "Bad search strategy: \"" << argv[1]
-              << "\". Must be [--simple] or [--smart].\n";
+  return infile;
+}
+
+// a regular file is mapped, anything else read as it comes
+static auto open_corpus(const int argc,
+                        const char* const* const argv,
+                        const char* const path) -> corpus_reader
+{
+  std::optional<corpus_reader> reader {corpus_reader::open(path)};
+
+  if ( ! reader.has_value() ) {
+    std::cerr << "Error opening file: \"" << path << "\"\n";
     print_help_message(argc, argv);
+    std::exit(EXIT_FAILURE);
+  }
+
+  return std::move(*reader);
+}
+
+// parses a count given on the command line,
+// exiting with an explanation naming what it counts if it is not a number
+template <typename Number = std::size_t>
+static auto parse_number(const int argc,
+                         const char* const* const argv,
+                         const std::string_view what,
+                         const std::string_view arg) -> Number
+{
+  Number number {};
+  const auto [end, error] {
+    std::from_chars(arg.data(), arg.data() + arg.size(), number)};
+
+  if ( error != std::errc {} || end != arg.data() + arg.size() ) {
+    std::cerr << "Bad " << what << ": \"" << arg << "\"\n";
+    print_help_message(argc, argv);
+    std::exit(EXIT_FAILURE);
+  }
+
+  return number;
+}
+
+// parses the N of `--threads N`
+//
+// 0 means one per hardware thread
+static auto parse_thread_count(const int argc,
+                               const char* const* const argv,
+                               const std::string_view count_arg)
+  -> std::size_t
+{
+  const auto thread_count {
+    parse_number(argc, argv, "thread count", count_arg)};
+
+  if ( thread_count == 0 ) {
+    return std::max(std::size_t {1},
+                    std::size_t {std::thread::hardware_concurrency()});
+  }
+
+  return thread_count;
+}
+
+static void print_duration(std::ostream& out,
+                           const std::chrono::steady_clock::duration time)
+{
+  out << "Took: "
+      << std::chrono::duration_cast<std::chrono::microseconds>(time)
+           .count()
+      << "us\n"
+      << "Equal to: "
+      << std::chrono::duration_cast<std::chrono::milliseconds>(time)
+           .count()
+      << "ms\n"
+      << "Equal to: "
+      << std::chrono::duration_cast<std::chrono::seconds>(time).count()
+      << "s\n";
+}
+
+static auto read_input(const int argc,
+                       const char* const* const argv,
+                       const char* const path) -> std::string
+{
+  std::ifstream infile {open_input(argc, argv, path)};
+  std::ostringstream buffer;
+  buffer << infile.rdbuf();
+  return std::move(buffer).str();
+}
+
+// calls visit with the box size of the board held in contents,
+// as a std::integral_constant
+//
+// the board size follows from the number of cells,
+// anything unrecognized being left for the 9x9 parser to reject
+template <typename Visitor>
+static auto visit_board_size(const std::string& contents, Visitor&& visit)
+  -> int
+{
+  const std::size_t cell_count {count_cell_symbols(contents)};
+
+  switch ( cell_count ) {
+    case board_shape<2>::cell_count:
+      return visit(std::integral_constant<unsigned, 2> {});
+    case board_shape<4>::cell_count:
+      return visit(std::integral_constant<unsigned, 4> {});
+    case board_shape<5>::cell_count:
+      return visit(std::integral_constant<unsigned, 5> {});
+    default:
+      return visit(std::integral_constant<unsigned, 3> {});
+  }
+}
+
+// the board held in contents,
+// exiting with where it is malformed if it is
+template <unsigned BoxSize>
+static auto parse_input(const std::string& contents)
+  -> basic_sudoku<BoxSize>
+{
+  auto [board, error] {parse_board<BoxSize>(contents)};
+
+  if ( ! board.has_value() ) {
+    std::cerr << "Bad puzzle: " << error << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+
+  return *board;
+}
+
+// solve a corpus of one-line puzzles, writing solutions to stdout
+// and a throughput report to stderr
+static auto run_batch(const int argc, const char* const* const argv) -> int
+{
+  using namespace std::literals;  // for operator""sv string_view literal
+
+  const bool has_thread_count {argc == 6 && "--threads"sv == argv[4]};
+
+  if ( argc != 4 && ! has_thread_count ) {
+    print_help_message(argc, argv);
+    return EXIT_FAILURE;
+  }
+
+  const std::size_t thread_count {
+    has_thread_count ? parse_thread_count(argc, argv, argv[5]) : 1};
+
+  const search_strategy& strategy {parse_strategy(argc, argv, argv[2])};
+  corpus_reader corpus {open_corpus(argc, argv, argv[3])};
+
+  std::ios_base::sync_with_stdio(false);
+
+  std::cerr << (thread_count == 1
+                  ? solve_batch(corpus, std::cout, strategy)
+                  : solve_batch_parallel(
+                    corpus, std::cout, strategy, thread_count));
+
+  if ( corpus.failed() ) {
+    std::cerr << "Error reading file: \"" << argv[3] << "\"\n";
     return EXIT_FAILURE;
   }
 
-  const bool be_smart {"--smart"sv == argv[1]};
+  return EXIT_SUCCESS;
+}
+
+// how the search statistics of a single solve are reported, if at all
+enum class stats_output {
+  none,
+  text,
+  json,
+};
+
+// how the result of a single solve is written to stdout
+enum class output_format {
+  text,
+  json,
+  csv,
+};
 
-  Sudoku sudoku {[argc, argv]() {
-    std::ifstream infile {argv[2]};
+// what may follow the input file of a single puzzle, in any order
+struct solve_options {
+  std::size_t thread_count {1};
+  stats_output stats {stats_output::none};
+  output_format format {output_format::text};
 
-    if ( ! infile.is_open() ) {
-      std::cerr << "Error opening file: \"" << argv[2] << "\"\n";
+  // for json and csv, which otherwise leave the boards out
+  bool print_boards {false};
+};
+
+// parses the options after the input file of a single puzzle,
+// exiting with an explanation if any are not understood
+static auto parse_solve_options(const int argc,
+                                const char* const* const argv)
+  -> solve_options
+{
+  using namespace std::literals;  // for operator""sv string_view literal
+
+  solve_options options {};
+
+  for ( int i {3}; i < argc; ++i ) {
+    const std::string_view option {argv[i]};
+
+    if ( option == "--threads"sv && i + 1 < argc ) {
+      ++i;
+      options.thread_count = parse_thread_count(argc, argv, argv[i]);
+    } else if ( option == "--stats"sv ) {
+      options.stats = stats_output::text;
+    } else if ( option == "--stats=json"sv ) {
+      options.stats = stats_output::json;
+    } else if ( option == "--format=text"sv ) {
+      options.format = output_format::text;
+    } else if ( option == "--format=json"sv ) {
+      options.format = output_format::json;
+    } else if ( option == "--format=csv"sv ) {
+      options.format = output_format::csv;
+    } else if ( option == "--boards"sv ) {
+      options.print_boards = true;
+    } else {
+      std::cerr << "Bad option: \"" << option << "\"\n";
       print_help_message(argc, argv);
       std::exit(EXIT_FAILURE);
     }
-    Sudoku retval;
-    infile >> retval;
-    return retval;
-  }()};
+  }
 
-  std::cout << "Beginning state:\n" << sudoku << '\n';
+  if ( options.format != output_format::text
+       && options.stats != stats_output::none ) {
+    std::cerr << "--format=json and --format=csv already include "
+                 "search statistics\n";
+    std::exit(EXIT_FAILURE);
+  }
 
-  // undocumented feature to just print an input file
-  if ( "--just-print"sv == argv[1] ) {
+  return options;
+}
+
+// user and system CPU time of every thread so far
+static auto cpu_times() noexcept
+  -> std::pair<std::chrono::nanoseconds, std::chrono::nanoseconds>
+{
+  ::rusage usage {};
+  ::getrusage(RUSAGE_SELF, &usage);
+
+  const auto to_duration {[](const ::timeval time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::seconds {time.tv_sec}
+      + std::chrono::microseconds {time.tv_usec});
+  }};
+
+  return {to_duration(usage.ru_utime), to_duration(usage.ru_stime)};
+}
+
+// the command line as typed, for the command of a run_record
+static auto command_line(const int argc, const char* const* const argv)
+  -> std::string
+{
+  std::string command {};
+
+  for ( const int i : std::views::iota(0, argc) ) {
+    command += i == 0 ? "" : " ";
+    command += argv[i];
+  }
+
+  return command;
+}
+
+// solve the puzzle held in contents, reporting how it went on stdout
+//
+// only 9x9 boards may use the exact cover engine or several threads,
+// and statistics are only kept for one thread
+template <unsigned BoxSize>
+static auto solve_input(const int argc,
+                        const char* const* const argv,
+                        const std::string& contents,
+                        const bool just_print,
+                        const solve_options& options) -> int
+{
+  basic_sudoku<BoxSize> sudoku {parse_input<BoxSize>(contents)};
+
+  const bool is_text {options.format == output_format::text};
+
+  // structured output keeps stdout for the record alone,
+  // so boards go to stderr, and only if asked for
+  std::ostream& board_out {is_text ? std::cout : std::cerr};
+  const bool print_boards {is_text || options.print_boards};
+
+  if ( print_boards ) {
+    board_out << "Beginning state:\n" << sudoku << '\n';
+  }
+
+  if ( just_print ) {
     return EXIT_SUCCESS;
   }
 
-  const auto optimization_callback {be_smart ? &trivial_move_optimization
-                                             : &null_optimization};
+  const auto& strategy {parse_strategy<BoxSize>(argc, argv, argv[1])};
+
+  if ( BoxSize != 3 && strategy.use_exact_cover ) {
+    std::cerr << "--dlx only solves 9x9 puzzles\n";
+    return EXIT_FAILURE;
+  }
+
+  // only the backtracking search on 9x9 boards has a parallel mode
+  const std::size_t thread_count {
+    BoxSize == 3 && ! strategy.use_exact_cover ? options.thread_count
+                                               : 1};
+  const bool stats_wanted {options.stats != stats_output::none};
+
+  if ( stats_wanted && ! search_stats::enabled ) {
+    std::cerr << "--stats needs a build with SEARCH_STATS on\n";
+    return EXIT_FAILURE;
+  }
+
+  if ( stats_wanted && thread_count != 1 ) {
+    std::cerr << "--stats only counts a search on one thread\n";
+    return EXIT_FAILURE;
+  }
+
+  const auto solve {[&](basic_sudoku<BoxSize>& board,
+                        search_stats* const stats) {
+    if constexpr ( BoxSize == 3 ) {
+      solver_context context {};
 
+      return thread_count == 1
+             ? context.solve(board, strategy, stats)
+             : solve_parallel(board,
+                              strategy.optimization_callback,
+                              strategy.selection_callback,
+                              thread_count,
+                              parallel_branch_threshold);
+    } else {
+      return board.solve(strategy.optimization_callback,
+                         strategy.selection_callback,
+                         stats);
+    }
+  }};
+
+  // the structured formats count the timed solve itself,
+  // without timing its phases, which is all the counting costs
+  const bool keep_stats {! is_text && search_stats::enabled
+                          && thread_count == 1};
+
+  search_stats stats {};
+  stats.time_phases = is_text;
+
+  const auto [start_user, start_system] {cpu_times()};
   const auto start_time {std::chrono::steady_clock::now()};
 
-  const auto [assignment_count,
-              solved] {sudoku.solve(optimization_callback)};
+  const auto [assignment_count, solved] {solve(
+    sudoku, stats_wanted || keep_stats ? &stats : nullptr)};
 
   const auto end_time {std::chrono::steady_clock::now()};
+  const auto [end_user, end_system] {cpu_times()};
+
+  if ( solved && print_boards ) {
+    board_out << "Solution state:\n" << sudoku << "\n\n";
+  }
+
+  if ( is_text ) {
+    if ( solved ) {
+      std::cout << "Solution found with: " << assignment_count
+                << " variable assignments\n";
+    } else {
+      std::cout << "No solution found" << '\n';
+    }
+
+    print_duration(std::cout, end_time - start_time);
+
+    if ( options.stats == stats_output::text ) {
+      std::cout << "Search statistics:\n" << stats;
+    } else if ( options.stats == stats_output::json ) {
+      write_json(std::cout, stats);
+      std::cout << '\n';
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  run_record record {};
+  record.command = command_line(argc, argv);
+  record.alg = std::string {strategy.flag.substr(2)};
+  record.puzzle = puzzle_name(argv[2]);
+  record.input_path = argv[2];
+  record.solved = solved;
+  record.assignment_count = assignment_count;
+  record.elapsed = end_time - start_time;
+  record.user_time = end_user - start_user;
+  record.system_time = end_system - start_system;
 
   if ( solved ) {
-    std::cout << "Solution state:\n" << sudoku << "\n\n";
-    std::cout << "Solution found with: " << assignment_count
-              << " variable assignments\n";
+    record.solution.resize(sudoku.cell_count);
+    static_cast<void>(sudoku.format_line(record.solution.data()));
+  }
+
+  if ( keep_stats ) {
+    record.stats = stats;
+  }
+
+  if ( options.format == output_format::json ) {
+    write_json(std::cout, record);
+  } else {
+    write_csv_header(std::cout);
+    write_csv(std::cout, record);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// count the solutions of the puzzle held in contents,
+// stopping once solution_limit have been found
+template <unsigned BoxSize>
+static auto count_input(const std::string& contents,
+                        const basic_search_strategy<BoxSize>& strategy,
+                        const std::size_t solution_limit) -> int
+{
+  basic_sudoku<BoxSize> sudoku {parse_input<BoxSize>(contents)};
+
+  std::cout << "Beginning state:\n" << sudoku << '\n';
+
+  const auto start_time {std::chrono::steady_clock::now()};
+
+  const auto [assignment_count, solution_count] {sudoku.count_solutions(
+    strategy.optimization_callback,
+    strategy.selection_callback,
+    solution_limit)};
+
+  const auto end_time {std::chrono::steady_clock::now()};
+
+  const bool stopped_early {solution_count != 0
+                            && solution_count == solution_limit};
+
+  if ( solution_count == 0 ) {
+    std::cout << "No solution found\n";
+  } else if ( stopped_early ) {
+    std::cout << "Stopped after: " << solution_count << " solutions\n";
   } else {
-    std::cout << "No solution found" << '\n';
-  }
-
-  std::cout << "Took: "
-            << std::chrono::duration_cast<std::chrono::microseconds>(
-                 end_time - start_time)
-                 .count()
-            << "us\n"
-            << "Equal to: "
-            << std::chrono::duration_cast<std::chrono::milliseconds>(
-                 end_time - start_time)
-                 .count()
-            << "ms\n"
-            << "Equal to: "
-            << std::chrono::duration_cast<std::chrono::seconds>(
-                 end_time - start_time)
-                 .count()
-            << "s\n";
+    std::cout << "Solutions found: " << solution_count << '\n';
+  }
+
+  // a limit of 1 cannot tell a unique solution from the first of several
+  if ( solution_count != 1 || ! stopped_early ) {
+    std::cout << "Unique: " << (solution_count == 1 ? "yes" : "no")
+              << '\n';
+  }
+
+  std::cout << "Searched with: " << assignment_count
+            << " variable assignments\n";
+
+  print_duration(std::cout, end_time - start_time);
+
+  return EXIT_SUCCESS;
+}
+
+// the arguments shared by --count and --enumerate,
+// `[limit] [strategy] [input_file.dat]` with the limit optional
+struct limited_search_args {
+  std::size_t solution_limit;
+  const char* flag;
+  std::string contents;
+};
+
+static auto parse_limited_search(const int argc,
+                                 const char* const* const argv,
+                                 const std::size_t default_limit)
+  -> limited_search_args
+{
+  if ( argc != 4 && argc != 5 ) {
+    print_help_message(argc, argv);
+    std::exit(EXIT_FAILURE);
+  }
+
+  const bool has_limit {argc == 5};
+  const std::size_t solution_limit {
+    has_limit ? parse_number(argc, argv, "solution limit", argv[2])
+              : default_limit};
+  const char* const flag {argv[has_limit ? 3 : 2]};
+  const char* const path {argv[has_limit ? 4 : 3]};
+
+  if ( parse_strategy(argc, argv, flag).use_exact_cover ) {
+    std::cerr << "--dlx cannot search past the first solution\n";
+    std::exit(EXIT_FAILURE);
+  }
+
+  return {solution_limit, flag, read_input(argc, argv, path)};
+}
+
+// report how many solutions a puzzle has, by default telling apart
+// no solution, a unique solution, and several solutions
+static auto run_count(const int argc, const char* const* const argv)
+  -> int
+{
+  const auto [solution_limit, flag, contents] {
+    parse_limited_search(argc, argv, 2)};
+
+  return visit_board_size(contents, [&](const auto box_size) {
+    return count_input<box_size()>(
+      contents,
+      parse_strategy<box_size()>(argc, argv, flag),
+      solution_limit);
+  });
+}
+
+// write solutions of the puzzle held in contents to stdout as they are
+// found, one line each, stopping once solution_limit have been written
+template <unsigned BoxSize>
+static auto enumerate_input(const std::string& contents,
+                            const basic_search_strategy<BoxSize>& strategy,
+                            const std::size_t solution_limit) -> int
+{
+  basic_sudoku<BoxSize> sudoku {parse_input<BoxSize>(contents)};
+
+  const auto start_time {std::chrono::steady_clock::now()};
+
+  basic_solution_generator<BoxSize> solutions {
+    sudoku, strategy.optimization_callback, strategy.selection_callback};
+
+  {
+    line_writer out {std::cout};
+
+    for ( const auto& solution : solutions ) {
+      out.write_with(solution.cell_count + 1,
+                     [&solution](char* const line) {
+                       *solution.format_line(line) = '\n';
+                     });
+
+      if ( solutions.solution_count() == solution_limit ) {
+        break;
+      }
+    }
+  }
+
+  const auto end_time {std::chrono::steady_clock::now()};
+
+  std::cerr << "Solutions: " << solutions.solution_count() << '\n'
+            << "Searched with: " << solutions.assignment_count()
+            << " variable assignments\n";
+  print_duration(std::cerr, end_time - start_time);
+
+  return EXIT_SUCCESS;
+}
+
+// stream every solution of a puzzle to stdout (0 for no limit)
+static auto run_enumerate(const int argc, const char* const* const argv)
+  -> int
+{
+  const auto [solution_limit, flag, contents] {
+    parse_limited_search(argc, argv, 0)};
+
+  std::ios_base::sync_with_stdio(false);
+
+  return visit_board_size(contents, [&](const auto box_size) {
+    return enumerate_input<box_size()>(
+      contents,
+      parse_strategy<box_size()>(argc, argv, flag),
+      solution_limit);
+  });
+}
+
+// convert a corpus of one-line puzzles to the packed format,
+// solving each one first if a strategy is given
+static auto run_pack(const int argc, const char* const* const argv)
+  -> int
+{
+  if ( argc != 4 && argc != 5 ) {
+    print_help_message(argc, argv);
+    return EXIT_FAILURE;
+  }
+
+  const search_strategy* const strategy {
+    argc == 5 ? &parse_strategy(argc, argv, argv[4]) : nullptr};
+
+  corpus_reader corpus {open_corpus(argc, argv, argv[2])};
+
+  std::ofstream outfile {argv[3], std::ios::binary};
+  if ( ! outfile.is_open() ) {
+    std::cerr << "Error opening file: \"" << argv[3] << "\"\n";
+    return EXIT_FAILURE;
+  }
+
+  std::cerr << pack_corpus(corpus, outfile, strategy);
+
+  if ( corpus.failed() ) {
+    std::cerr << "Error reading file: \"" << argv[2] << "\"\n";
+    return EXIT_FAILURE;
+  }
+
+  if ( ! outfile ) {
+    std::cerr << "Error writing file: \"" << argv[3] << "\"\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// write the puzzles, or solutions, of a packed corpus as one-line text
+static auto run_unpack(const int argc, const char* const* const argv)
+  -> int
+{
+  using namespace std::literals;  // for operator""sv string_view literal
+
+  const bool with_solutions {argc == 4 && "--solutions"sv == argv[3]};
+
+  if ( argc != 3 && ! with_solutions ) {
+    print_help_message(argc, argv);
+    return EXIT_FAILURE;
+  }
+
+  const std::optional<packed_corpus> corpus {packed_corpus::open(argv[2])};
+
+  if ( ! corpus.has_value() ) {
+    std::cerr << "Not a packed corpus: \"" << argv[2] << "\"\n";
+    return EXIT_FAILURE;
+  }
+
+  if ( with_solutions && ! corpus->has_solutions() ) {
+    std::cerr << "No solutions stored in: \"" << argv[2] << "\"\n";
+    return EXIT_FAILURE;
+  }
+
+  std::ios_base::sync_with_stdio(false);
+
+  std::cerr << unpack_corpus(*corpus, std::cout, with_solutions);
+
+  return EXIT_SUCCESS;
+}
+
+// grade a single puzzle by the techniques it needs
+static auto run_rate(const int argc, const char* const* const argv) -> int
+{
+  if ( argc != 3 ) {
+    print_help_message(argc, argv);
+    return EXIT_FAILURE;
+  }
+
+  const Sudoku sudoku {parse_input<3>(read_input(argc, argv, argv[2]))};
+
+  std::cout << "Beginning state:\n" << sudoku << '\n';
+
+  const auto start_time {std::chrono::steady_clock::now()};
+  const difficulty_rating rating {rate(sudoku)};
+  const auto end_time {std::chrono::steady_clock::now()};
+
+  std::cout << rating;
+  print_duration(std::cout, end_time - start_time);
 
   return EXIT_SUCCESS;
 }
+
+// grade a corpus of one-line puzzles, writing ratings to stdout
+// and a throughput report to stderr,
+// solving each one too if a strategy follows the corpus file
+static auto run_rate_batch(const int argc, const char* const* const argv)
+  -> int
+{
+  using namespace std::literals;  // for operator""sv string_view literal
+
+  const bool has_strategy {argc == 4 || argc == 6};
+  const int thread_option {has_strategy ? 4 : 3};
+  const bool has_thread_count {argc == thread_option + 2
+                               && "--threads"sv == argv[thread_option]};
+
+  if ( argc != thread_option && ! has_thread_count ) {
+    print_help_message(argc, argv);
+    return EXIT_FAILURE;
+  }
+
+  const std::size_t thread_count {
+    has_thread_count
+      ? parse_thread_count(argc, argv, argv[thread_option + 1])
+      : 1};
+  const search_strategy* const strategy {
+    has_strategy ? &parse_strategy(argc, argv, argv[3]) : nullptr};
+
+  corpus_reader corpus {open_corpus(argc, argv, argv[2])};
+
+  std::ios_base::sync_with_stdio(false);
+
+  std::cerr << rate_batch(corpus, std::cout, thread_count, strategy);
+
+  if ( corpus.failed() ) {
+    std::cerr << "Error reading file: \"" << argv[2] << "\"\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// write freshly generated puzzles with unique solutions to stdout,
+// and a throughput report to stderr
+static auto run_generate(const int argc, const char* const* const argv)
+  -> int
+{
+  using namespace std::literals;  // for operator""sv string_view literal
+
+  // the options come in pairs after the count
+  if ( argc < 3 || argc % 2 != 1 ) {
+    print_help_message(argc, argv);
+    return EXIT_FAILURE;
+  }
+
+  const std::size_t puzzle_count {
+    parse_number(argc, argv, "puzzle count", argv[2])};
+
+  generator_options options {};
+  std::uint64_t seed {std::random_device {}()};
+  std::size_t thread_count {1};
+
+  for ( int i {3}; i < argc; i += 2 ) {
+    const std::string_view option {argv[i]};
+    const std::string_view value {argv[i + 1]};
+
+    if ( option == "--clues"sv ) {
+      options.target_clue_count =
+        parse_number(argc, argv, "clue count", value);
+    } else if ( option == "--symmetry"sv ) {
+      const auto pattern {parse_symmetry(value)};
+
+      if ( ! pattern.has_value() ) {
+        std::cerr << "Bad symmetry: \"" << value << "\"\n";
+        print_help_message(argc, argv);
+        return EXIT_FAILURE;
+      }
+
+      options.pattern = *pattern;
+    } else if ( option == "--seed"sv ) {
+      seed = parse_number<std::uint64_t>(argc, argv, "seed", value);
+    } else if ( option == "--threads"sv ) {
+      thread_count = parse_thread_count(argc, argv, value);
+    } else {
+      std::cerr << "Bad option: \"" << option << "\"\n";
+      print_help_message(argc, argv);
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::ios_base::sync_with_stdio(false);
+
+  std::cerr << "Seed: " << seed << '\n'
+            << generate_batch(
+                 std::cout, puzzle_count, seed, options, thread_count);
+
+  return EXIT_SUCCESS;
+}
+
+auto main(const int argc, const char* const* const argv) -> int
+{
+  using namespace std::literals;  // for operator""sv string_view literal
+
+  for ( const int i : std::views::iota(1, argc) ) {
+    constexpr static auto help_pred {
+      supl::equals_any_of("--help"sv, "-h"sv)};
+    if ( help_pred(argv[i]) ) {
+      print_help_message(argc, argv);
+      return EXIT_SUCCESS;
+    }
+  }
+
+  if ( argc >= 2 && "--batch"sv == argv[1] ) {
+    return run_batch(argc, argv);
+  }
+
+  if ( argc >= 2 && "--pack"sv == argv[1] ) {
+    return run_pack(argc, argv);
+  }
+
+  if ( argc >= 2 && "--unpack"sv == argv[1] ) {
+    return run_unpack(argc, argv);
+  }
+
+  if ( argc >= 2 && "--rate"sv == argv[1] ) {
+    return run_rate(argc, argv);
+  }
+
+  if ( argc >= 2 && "--rate-batch"sv == argv[1] ) {
+    return run_rate_batch(argc, argv);
+  }
+
+  if ( argc >= 2 && "--generate"sv == argv[1] ) {
+    return run_generate(argc, argv);
+  }
+
+  if ( argc >= 2 && "--count"sv == argv[1] ) {
+    return run_count(argc, argv);
+  }
+
+  if ( argc >= 2 && "--enumerate"sv == argv[1] ) {
+    return run_enumerate(argc, argv);
+  }
+
+  if ( argc < 3 ) {
+    print_help_message(argc, argv);
+    return EXIT_FAILURE;
+  }
+
+  const solve_options options {parse_solve_options(argc, argv)};
+
+  // undocumented feature to just print an input file
+  const bool just_print {"--just-print"sv == argv[1]};
+
+  // every board size takes the same flags,
+  // so check them before reading any input
+  if ( ! just_print ) {
+    static_cast<void>(parse_strategy(argc, argv, argv[1]));
+  }
+
+  const std::string contents {read_input(argc, argv, argv[2])};
+
+  return visit_board_size(contents, [&](const auto box_size) {
+    return solve_input<box_size()>(
+      argc, argv, contents, just_print, options);
+  });
+}
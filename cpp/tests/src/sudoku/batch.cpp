@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "batch.hpp"
+#include "corpus_reader.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+using namespace supl::literals::size_t_literal;
+
+constexpr static std::string_view hard_line {
+  "7........6..41.25..13.95...86.......3.1...4.5.......86...84.53..42.36..7"
+  "........9"};
+
+constexpr static std::string_view hard_solution {
+  "7253681946894172534132957688679543213916824752541739861768495329425368175"
+  "38721649"};
+
+constexpr static std::string_view impossible_line {
+  "73218.49656.29471381436.52.3759128.442687513919843.657653.27941941653.72"
+  "28..4.365"};
+
+static auto test_from_line() -> supl::test_results
+{
+  supl::test_results results;
+
+  const auto dots {Sudoku::from_line(hard_line)};
+  results.enforce_true(dots.has_value());
+
+  std::string zeros {hard_line};
+  std::ranges::replace(zeros, '.', '0');
+  std::string underscores {hard_line};
+  std::ranges::replace(underscores, '.', '_');
+
+  results.enforce_true(dots == Sudoku::from_line(zeros));
+  results.enforce_true(dots == Sudoku::from_line(underscores));
+  results.enforce_true(
+    dots == Sudoku::from_line(std::string {hard_line} + "\r"));
+
+  results.enforce_equal(dots->data().at(0), '7');
+  results.enforce_equal(dots->data().at(1), '_');
+
+  // too short, too long, bad character
+  results.enforce_false(
+    Sudoku::from_line(hard_line.substr(1)).has_value());
+  results.enforce_false(
+    Sudoku::from_line(std::string {hard_line} + "1").has_value());
+  std::string bad_char {hard_line};
+  bad_char.at(40) = 'x';
+  results.enforce_false(Sudoku::from_line(bad_char).has_value());
+
+  return results;
+}
+
+static auto test_solve_batch() -> supl::test_results
+{
+  supl::test_results results;
+
+  for ( const search_strategy& strategy : search_strategies ) {
+    std::stringstream in;
+    in << hard_line << '\n'
+       << '\n'
+       << impossible_line << '\n'
+       << "not a puzzle\n"
+       << hard_line << "\r\n";
+
+    corpus_reader reader {in};
+    std::stringstream out;
+    const batch_report report {solve_batch(reader, out, strategy)};
+
+    results.enforce_equal(report.puzzle_count, 4_z, strategy.flag);
+    results.enforce_equal(report.failure_count, 2_z, strategy.flag);
+
+    std::string expected {hard_solution};
+    expected += '\n';
+    expected += batch_failure_prefix;
+    expected += impossible_line;
+    expected += '\n';
+    expected += batch_failure_prefix;
+    expected += "not a puzzle\n";
+    expected += hard_solution;
+    expected += '\n';
+
+    results.enforce_equal(out.str(), expected, strategy.flag);
+  }
+
+  return results;
+}
+
+static auto test_parallel_matches_serial() -> supl::test_results
+{
+  supl::test_results results;
+
+  // enough puzzles for many chunks, mixing fast and failing ones
+  std::string corpus;
+  for ( std::size_t i {0}; i < 400; ++i ) {
+    corpus += (i % 7 == 3) ? impossible_line : hard_line;
+    corpus += '\n';
+  }
+
+  const search_strategy& strategy {*find_strategy("--hidden")};
+
+  corpus_reader serial_in {corpus};
+  std::stringstream serial_out;
+  const batch_report serial {solve_batch(serial_in, serial_out, strategy)};
+
+  for ( const std::size_t thread_count : {2_z, 3_z, 8_z} ) {
+    std::stringstream parallel_stream {corpus};
+    corpus_reader parallel_in {parallel_stream};
+    std::stringstream parallel_out;
+    const batch_report parallel {solve_batch_parallel(
+      parallel_in, parallel_out, strategy, thread_count)};
+
+    const std::string message {supl::to_string(thread_count)};
+
+    results.enforce_equal(parallel.thread_count, thread_count, message);
+    results.enforce_equal(
+      parallel.puzzle_count, serial.puzzle_count, message);
+    results.enforce_equal(
+      parallel.failure_count, serial.failure_count, message);
+    results.enforce_true(parallel_out.str() == serial_out.str(), message);
+  }
+
+  return results;
+}
+
+static auto batch() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("single line parsing", &test_from_line);
+  section.add_test("batch solving", &test_solve_batch);
+  section.add_test("parallel batch solving",
+                   &test_parallel_matches_serial);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(batch());
+
+  return runner.run();
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "board_parser.hpp"
+#include "line_writer.hpp"
+#include "sudoku.hpp"
+
+using namespace supl::literals::size_t_literal;
+
+// the grid as operator<< used to build it, a string at a time
+template <unsigned BoxSize>
+static auto reference_grid(const basic_sudoku<BoxSize>& board)
+  -> std::string
+{
+  constexpr unsigned side {basic_sudoku<BoxSize>::side};
+
+  std::string output {"\n"};
+
+  for ( unsigned row {0}; row < side; ++row ) {
+    std::string line;
+
+    for ( unsigned col {0}; col < side; ++col ) {
+      if ( col != 0 ) {
+        line += col % BoxSize == 0 ? " | " : " ";
+      }
+      line += board.data().at(row * side + col);
+    }
+
+    if ( row != 0 && row % BoxSize == 0 ) {
+      std::string divider {line};
+      std::ranges::replace_if(
+        divider, [](const char c) { return c != '|'; }, '-');
+      std::ranges::replace(divider, '|', '+');
+      output += divider + '\n';
+    }
+
+    output += line + '\n';
+  }
+
+  return output;
+}
+
+// every symbol in turn, blanks included, so each cell differs from its
+// neighbours; not a legal board, which formatting does not care about
+template <unsigned BoxSize>
+static auto patterned_board() -> basic_sudoku<BoxSize>
+{
+  using board_t = basic_sudoku<BoxSize>;
+
+  std::array<char, board_t::cell_count> cells {};
+  for ( std::size_t i {0}; i < cells.size(); ++i ) {
+    cells.at(i) = board_t::charset.at(i % board_t::charset.size());
+  }
+
+  return board_t {cells};
+}
+
+template <unsigned BoxSize>
+static void check_size(supl::test_results& results)
+{
+  using board_t = basic_sudoku<BoxSize>;
+
+  const board_t board {patterned_board<BoxSize>()};
+  const std::string expected {reference_grid(board)};
+  const std::string message {"box size " + supl::to_string(BoxSize)};
+
+  results.enforce_equal(board_t::grid_size, expected.size(), message);
+
+  std::array<char, board_t::grid_size> grid {};
+  results.enforce_true(board.format_grid(grid.data())
+                         == grid.data() + grid.size(),
+                       message);
+  results.enforce_equal(std::string {grid.data(), grid.size()},
+                        expected,
+                        message);
+
+  std::ostringstream printed;
+  printed << board;
+  results.enforce_equal(printed.str(), expected, message);
+
+  std::array<char, board_t::cell_count> line {};
+  results.enforce_true(board.format_line(line.data())
+                         == line.data() + line.size(),
+                       message);
+  results.enforce_true(line == board.data(), message);
+
+  // both read back as the same board
+  results.enforce_true(
+    parse_board<BoxSize>({grid.data(), grid.size()}).board == board,
+    message);
+  results.enforce_true(
+    parse_board<BoxSize>({line.data(), line.size()}).board == board,
+    message);
+}
+
+static auto test_matches_reference() -> supl::test_results
+{
+  supl::test_results results;
+
+  check_size<2>(results);
+  check_size<3>(results);
+  check_size<4>(results);
+  check_size<5>(results);
+
+  results.enforce_equal(Sudoku::grid_width, 21_z);
+
+  return results;
+}
+
+static auto test_write_with() -> supl::test_results
+{
+  supl::test_results results;
+
+  const Sudoku board {patterned_board<3>()};
+  const std::string line {board.data().begin(), board.data().end()};
+
+  std::ostringstream out;
+  std::string expected;
+
+  {
+    // too small for even one board, so it must grow first
+    line_writer writer {out, 16};
+
+    for ( int i {0}; i < 3; ++i ) {
+      writer.write_with(Sudoku::cell_count + 1, [&board](char* const at) {
+        *board.format_line(at) = '\n';
+      });
+      expected += line + '\n';
+
+      writer.write_line("between");
+      expected += "between\n";
+    }
+
+    writer.write_with(Sudoku::grid_size, [&board](char* const at) {
+      board.format_grid(at);
+    });
+    expected += reference_grid(board);
+  }
+
+  results.enforce_equal(out.str(), expected);
+
+  return results;
+}
+
+static auto board_formatter_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("matches the reference", &test_matches_reference);
+  section.add_test("line_writer::write_with", &test_write_with);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(board_formatter_tests());
+
+  return runner.run();
+}
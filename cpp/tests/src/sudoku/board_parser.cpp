@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "board_parser.hpp"
+#include "sudoku.hpp"
+
+using namespace supl::literals::size_t_literal;
+
+constexpr static std::string_view hard_line {
+  "7........6..41.25..13.95...86.......3.1...4.5......."
+  "86...84.53..42.36..7........9"};
+
+constexpr static std::string_view hard_grid {
+  "7 _ _ _ _ _ _ _ _\n"
+  "6 _ _ 4 1 _ 2 5 _\n"
+  "_ 1 3 _ 9 5 _ _ _\n"
+  "8 6 _ _ _ _ _ _ _\n"
+  "3 _ 1 _ _ _ 4 _ 5\n"
+  "_ _ _ _ _ _ _ 8 6\n"
+  "_ _ _ 8 4 _ 5 3 _\n"
+  "_ 4 2 _ 3 6 _ _ 7\n"
+  "_ _ _ _ _ _ _ _ 9\n"};
+
+static auto test_formats() -> supl::test_results
+{
+  supl::test_results results;
+
+  const auto from_line {parse_board<3>(hard_line)};
+  results.enforce_true(from_line.board.has_value());
+  results.enforce_true(from_line.error.kind == parse_error_kind::none);
+  results.enforce_equal(from_line.board->data().at(0), '7');
+  results.enforce_equal(from_line.board->data().at(1), '_');
+
+  std::string zeros {hard_line};
+  std::ranges::replace(zeros, '.', '0');
+
+  const auto from_grid {parse_board<3>(hard_grid)};
+  results.enforce_true(from_grid.board == from_line.board, "grid");
+  results.enforce_true(parse_board<3>(zeros).board == from_line.board,
+                       "zeros");
+
+  // what operator<< writes reads back the same
+  std::ostringstream printed;
+  printed << *from_line.board;
+  results.enforce_true(
+    parse_board<3>(printed.str()).board == from_line.board, "printed");
+
+  std::string crlf {hard_grid};
+  for ( std::size_t i {crlf.find('\n')}; i != std::string::npos;
+        i = crlf.find('\n', i + 2) ) {
+    crlf.insert(i, 1, '\r');
+  }
+  results.enforce_true(parse_board<3>(crlf).board == from_line.board,
+                       "crlf");
+
+  return results;
+}
+
+static auto test_errors() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::string bad {hard_grid};
+  // row 3, column 5 of the text
+  bad.at(18 * 2 + 4) = 'x';
+
+  const parse_error bad_character {parse_board<3>(bad).error};
+  results.enforce_true(bad_character.kind
+                       == parse_error_kind::bad_character);
+  results.enforce_equal(bad_character.offset, 40_z);
+  results.enforce_equal(bad_character.line, 3_z);
+  results.enforce_equal(bad_character.column, 5_z);
+  results.enforce_equal(bad_character.character, 'x');
+  results.enforce_equal(bad_character.cell_count, 20_z);
+
+  std::ostringstream message;
+  message << bad_character;
+  results.enforce_equal(
+    message.str(),
+    std::string {"line 3, column 5: unexpected 'x' after 20 cells"});
+
+  // letters are digits only on larger boards, and never lowercase
+  const std::string almost {hard_line.substr(0, 80)};
+  results.enforce_true(parse_board<3>(almost + "A").error.kind
+                       == parse_error_kind::bad_character);
+  results.enforce_true(parse_board<3>(almost + "\xC3").error.kind
+                       == parse_error_kind::bad_character);
+
+  const parse_error too_few {parse_board<3>(almost).error};
+  results.enforce_true(too_few.kind == parse_error_kind::too_few_cells);
+  results.enforce_equal(too_few.offset, 80_z);
+  results.enforce_equal(too_few.cell_count, 80_z);
+
+  const parse_error too_many {
+    parse_board<3>(std::string {hard_line} + "  1").error};
+  results.enforce_true(too_many.kind == parse_error_kind::too_many_cells);
+  results.enforce_equal(too_many.offset, 83_z);
+  results.enforce_equal(too_many.character, '1');
+
+  results.enforce_true(parse_board<3>("").error.kind
+                       == parse_error_kind::too_few_cells);
+
+  return results;
+}
+
+static auto test_sizes() -> supl::test_results
+{
+  supl::test_results results;
+
+  const auto small {parse_board<2>("12.4 34__ 2..1 4.0.")};
+  results.enforce_true(small.board.has_value());
+  results.enforce_equal(small.board->data().at(3), '4');
+  results.enforce_true(
+    parse_board<2>("5" + std::string(15, '.')).error.kind
+    == parse_error_kind::bad_character);
+
+  std::string large(256, '.');
+  large.at(0) = 'G';
+  large.at(100) = 'A';
+  large.at(255) = '9';
+  const auto sixteen {parse_board<4>(large)};
+  results.enforce_true(sixteen.board.has_value());
+  results.enforce_equal(sixteen.board->data().at(0), 'G');
+  results.enforce_equal(sixteen.board->data().at(100), 'A');
+
+  large.at(50) = 'H';
+  const parse_error past_g {parse_board<4>(large).error};
+  results.enforce_true(past_g.kind == parse_error_kind::bad_character);
+  results.enforce_equal(past_g.offset, 50_z);
+
+  results.enforce_equal(count_cell_symbols(hard_grid), 81_z);
+  results.enforce_equal(count_cell_symbols("1 2 | 3\n-+-\n4"), 4_z);
+
+  return results;
+}
+
+// the rules as a reader would first write them, one byte at a time
+static auto reference_parse(const std::string_view text)
+  -> std::pair<std::string, parse_error_kind>
+{
+  std::string cells;
+
+  for ( const char symbol : text ) {
+    if ( Sudoku::is_separator_symbol(symbol) ) {
+      continue;
+    }
+
+    if ( ! Sudoku::is_digit_symbol(symbol)
+         && ! Sudoku::is_blank_symbol(symbol) ) {
+      return {cells, parse_error_kind::bad_character};
+    }
+
+    if ( cells.size() == Sudoku::cell_count ) {
+      return {cells, parse_error_kind::too_many_cells};
+    }
+
+    cells += Sudoku::is_blank_symbol(symbol) ? '_' : symbol;
+  }
+
+  return {cells,
+          cells.size() == Sudoku::cell_count
+            ? parse_error_kind::none
+            : parse_error_kind::too_few_cells};
+}
+
+static auto test_matches_reference() -> supl::test_results
+{
+  supl::test_results results;
+
+  // mostly cells, so many texts come close to a whole board
+  constexpr std::string_view alphabet {
+    "123456789123456789123456789.0_.0_ \n\r\t|-+xA"};
+
+  std::mt19937 rng {12345};
+
+  for ( int i {0}; i < 4000; ++i ) {
+    std::string text(81 + rng() % 120, ' ');
+    for ( char& symbol : text ) {
+      symbol = alphabet[rng() % alphabet.size()];
+    }
+
+    // most texts have a bad character early on,
+    // so clean some up to exercise the long paths
+    if ( i % 2 == 0 ) {
+      std::ranges::replace(text, 'x', ' ');
+      std::ranges::replace(text, 'A', '5');
+    }
+
+    const auto [cells, kind] {reference_parse(text)};
+    const auto parsed {parse_board<3>(text)};
+
+    const std::string message {text};
+    results.enforce_true(parsed.error.kind == kind, message);
+    results.enforce_equal(parsed.error.cell_count,
+                          kind == parse_error_kind::none ? 0_z
+                                                         : cells.size(),
+                          message);
+
+    if ( parsed.board.has_value() ) {
+      results.enforce_equal(
+        std::string {parsed.board->data().begin(),
+                     parsed.board->data().end()},
+        cells,
+        message);
+    }
+  }
+
+  return results;
+}
+
+static auto test_stream_extraction() -> supl::test_results
+{
+  supl::test_results results;
+
+  // two boards in a row, each read only as far as its last cell
+  std::istringstream in {std::string {hard_grid}
+                         + std::string {hard_line}};
+
+  Sudoku first {};
+  Sudoku second {};
+  in >> first >> second;
+
+  results.enforce_true(static_cast<bool>(in));
+  results.enforce_true(first == *Sudoku::from_line(hard_line));
+  results.enforce_true(second == first);
+
+  Sudoku untouched {*Sudoku::from_line(hard_line)};
+
+  std::istringstream bad {"1 2 x"};
+  bad >> untouched;
+  results.enforce_true(bad.fail());
+  results.enforce_false(bad.eof());
+  results.enforce_true(untouched == first);
+
+  // the offending character is left for the caller
+  bad.clear();
+  results.enforce_equal(static_cast<char>(bad.get()), 'x');
+
+  std::istringstream short_input {std::string {hard_line.substr(0, 40)}};
+  short_input >> untouched;
+  results.enforce_true(short_input.fail());
+  results.enforce_true(short_input.eof());
+  results.enforce_true(untouched == first);
+
+  return results;
+}
+
+static auto board_parser_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("formats", &test_formats);
+  section.add_test("errors", &test_errors);
+  section.add_test("board sizes", &test_sizes);
+  section.add_test("matches byte at a time reference",
+                   &test_matches_reference);
+  section.add_test("operator>>", &test_stream_extraction);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(board_parser_tests());
+
+  return runner.run();
+}
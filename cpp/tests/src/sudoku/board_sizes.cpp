@@ -0,0 +1,222 @@
+#include <array>
+#include <cstddef>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "peer_tables.hpp"
+#include "solver_state.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+// a valid solution, built from shifted copies of the first row
+template <unsigned BoxSize>
+static auto pattern_solution() -> basic_sudoku<BoxSize>
+{
+  using board_t = basic_sudoku<BoxSize>;
+  constexpr unsigned side {board_t::side};
+
+  std::array<char, board_t::cell_count> cells {};
+  for ( const unsigned row : std::views::iota(0U, side) ) {
+    for ( const unsigned col : std::views::iota(0U, side) ) {
+      const unsigned digit {
+        (BoxSize * (row % BoxSize) + row / BoxSize + col) % side};
+      cells.at(row * side + col) = board_t::digit_symbol(digit);
+    }
+  }
+
+  return board_t {cells};
+}
+
+// the puzzles of inputs/more_examples, in the one-line format
+
+constexpr std::string_view puzzle_4x4 {
+    "__3___4_2_1_14_3"};
+
+constexpr std::string_view puzzle_16x16 {
+    "___BD________4__5_4_6_B_CD____18_D_G_E___A_4_3F__7E8A_95___3D2__"
+    "9_____4_G_36C____CD_1_____4A__G_B5_4_6_G_C2D_79EGF_3_D289__7__B4"
+    "D_G___C__4193___6___2___7EC84_A_7_8C4____35B____A_9__B__D_F__8_C"
+    "__F_8_DE_9___5_A_917_____G6F_CED_B_AGF_______1_7____91__3_A__F__"};
+
+constexpr std::string_view puzzle_25x25 {
+    "____6F__N___IC_E___4____G____7J__I___3OG_LA____P49K5_JC_M1_OD___"
+    "___F7N2L6_AM13____D4PL2_6AK_JCI8H_N_E__9__2_B6__N__M_GO3K5__J_O_"
+    "3_4A_D_____B__IK5J___NGC5_K_9O1_P_D_4__N_HF62__APD4___6L_7J_8___"
+    "_M__C_5_F6_B_NJ7H_C_5K_______O__3J7_N__GC_K_9_M3F____A__D__KC5_1"
+    "4_O9E______H___________9DBEP___6_L_K_GC_8J_H___HJ_3____4O_1N___6"
+    "___PD_2_L_H__7J_3C____DA_4M__1BEP___N26___7J_____O_K_C5CI__5K___"
+    "1___DM7N2HF___AE_NF_H_CIJ53_________P4D9M__9_DE_BALN7F__O__1__I_"
+    "_8___K1__4_____L_CI__J__HF__B__L27________P4M_9O__G___MO_PLA__F_"
+    "_N_1G_3_5JI87_AE__6H___J58I7D_O_M1G3__HF26N75J8IG________E_9__O_"
+    "G_C3O_9M4ALE___J7_8___26__87__1GK_9DM__HF_____BEP"};
+
+template <unsigned BoxSize>
+static void check_solves(const std::string_view line,
+                         const std::string_view flag,
+                         supl::test_results& results)
+{
+  const auto context {supl::to_string(BoxSize) + std::string {flag}};
+
+  const auto parsed {basic_sudoku<BoxSize>::from_line(line)};
+  const auto* const strategy {find_strategy<BoxSize>(flag)};
+  if ( ! parsed.has_value() || strategy == nullptr ) {
+    results.enforce_true(false, context);
+    return;
+  }
+
+  const auto& puzzle {*parsed};
+  auto board {puzzle};
+
+  const auto [assignment_count, solved] {board.solve(
+    strategy->optimization_callback, strategy->selection_callback)};
+
+  results.enforce_true(solved, context);
+  results.enforce_true(board.is_solved(), context);
+  results.enforce_true(assignment_count > 0, context);
+
+  // clues are untouched
+  for ( const std::size_t cell :
+        std::views::iota(std::size_t {0}, puzzle.cell_count) ) {
+    if ( puzzle.data().at(cell) != '_' ) {
+      results.enforce_equal(
+        board.data().at(cell), puzzle.data().at(cell), context);
+    }
+  }
+}
+
+static auto test_solve_each_size() -> supl::test_results
+{
+  supl::test_results results;
+
+  for ( const std::string_view flag :
+        {"--simple", "--smart", "--mrv", "--hidden"} ) {
+    check_solves<2>(puzzle_4x4, flag, results);
+  }
+
+  check_solves<4>(puzzle_16x16, "--smart", results);
+  check_solves<4>(puzzle_16x16, "--hidden", results);
+  check_solves<5>(puzzle_25x25, "--hidden", results);
+
+  return results;
+}
+
+static auto test_checking() -> supl::test_results
+{
+  supl::test_results results;
+
+  results.enforce_true(pattern_solution<2>().is_solved());
+  results.enforce_true(pattern_solution<4>().is_solved());
+  results.enforce_true(pattern_solution<5>().is_solved());
+
+  // a duplicate in the last box of a 16x16 board
+  auto broken {pattern_solution<4>()};
+  broken.set_cell({15, 15}, broken.data().at(254));
+  results.enforce_false(broken.is_valid());
+
+  const auto puzzle {basic_sudoku<5>::from_line(puzzle_25x25)};
+  results.enforce_true(puzzle.has_value());
+  if ( puzzle.has_value() ) {
+    results.enforce_true(puzzle->is_valid());
+    results.enforce_false(puzzle->is_solved());
+    results.enforce_true(puzzle->has_legal_assignments());
+  }
+
+  return results;
+}
+
+static auto test_symbols() -> supl::test_results
+{
+  supl::test_results results;
+
+  results.enforce_equal(basic_sudoku<2>::digit_symbol(3), '4');
+  results.enforce_equal(basic_sudoku<4>::digit_symbol(15), 'G');
+  results.enforce_equal(basic_sudoku<5>::digit_symbol(24), 'P');
+  results.enforce_equal(basic_sudoku<5>::digit_index('A'), 9U);
+
+  results.enforce_false(basic_sudoku<2>::is_digit_symbol('5'));
+  results.enforce_true(basic_sudoku<4>::is_digit_symbol('G'));
+  results.enforce_false(basic_sudoku<4>::is_digit_symbol('H'));
+  results.enforce_false(basic_sudoku<3>::is_digit_symbol('A'));
+
+  const auto parsed {basic_sudoku<2>::from_line("1.3.0._.2...4..3")};
+  results.enforce_true(parsed.has_value());
+  if ( parsed.has_value() ) {
+    results.enforce_equal(parsed->data().at(0), '1');
+    results.enforce_equal(parsed->data().at(1), '_');
+    results.enforce_equal(parsed->data().at(15), '3');
+  }
+
+  results.enforce_false(
+    basic_sudoku<2>::from_line("1.3.0._.2...5..3").has_value());
+
+  return results;
+}
+
+static auto test_printing() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::ostringstream printed;
+  printed << pattern_solution<2>();
+
+  results.enforce_equal(printed.str(),
+                        std::string {"\n"
+                                     "1 2 | 3 4\n"
+                                     "3 4 | 1 2\n"
+                                     "----+----\n"
+                                     "2 3 | 4 1\n"
+                                     "4 1 | 2 3\n"});
+
+  return results;
+}
+
+static auto test_geometry() -> supl::test_results
+{
+  supl::test_results results;
+
+  results.enforce_equal(board_geometry<2>::peer_count, 7U);
+  results.enforce_equal(board_geometry<3>::peer_count, 20U);
+  results.enforce_equal(board_geometry<4>::peer_count, 39U);
+  results.enforce_equal(board_geometry<5>::peer_count, 64U);
+
+  // the last cell of a 25x25 board is in the last row, column, and box
+  using geometry = board_geometry<5>;
+  results.enforce_equal(geometry::positions.rows.at(624), 24);
+  results.enforce_equal(geometry::positions.cols.at(624), 24);
+  results.enforce_equal(geometry::positions.boxes.at(624), 24);
+  results.enforce_equal(geometry::units.at(74).at(24), 624);
+  results.enforce_equal(geometry::peers.at(624).at(63), 623);
+  results.enforce_equal(geometry::peers.at(0).at(0), 1);
+
+  return results;
+}
+
+static auto board_sizes() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("solve each size", &test_solve_each_size);
+  section.add_test("checking", &test_checking);
+  section.add_test("symbols", &test_symbols);
+  section.add_test("printing", &test_printing);
+  section.add_test("geometry", &test_geometry);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(board_sizes());
+
+  return runner.run();
+}
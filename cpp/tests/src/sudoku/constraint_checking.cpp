@@ -1,6 +1,11 @@
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <random>
 #include <ranges>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include <supl/algorithm.hpp>
 #include <supl/utility.hpp>
@@ -37,12 +42,13 @@ static auto test_checking_of_populated_board() -> supl::test_results
   for ( const unsigned row : std::views::iota(0U, 9U) ) {
     for ( const unsigned col : std::views::iota(0U, 9U) ) {
       Sudoku illegal {legal};
-      char& fail_point = illegal.mdview()(row, col);
+      char fail_point = legal.mdview()(row, col);
 
       ++fail_point;
       if ( fail_point == '9' + 1 ) {
         fail_point = '1';
       }
+      illegal.set_cell({row, col}, fail_point);
 
       results.enforce_false(illegal.is_solved());
     }
@@ -62,8 +68,7 @@ static void run_is_valid_check(const run_data& data,
                                supl::test_results& results)
 {
   const auto& [idxs, cell_to, valid] {data};
-  const auto& [row, col] {idxs};
-  board.mdview()(row, col) = cell_to;
+  board.set_cell(idxs, cell_to);
   results.enforce_equal(
     board.is_valid(), valid, supl::to_string(std::pair {idxs, cell_to}));
 }
@@ -391,6 +396,139 @@ static auto test_has_legal_assignments() -> supl::test_results
   return results;
 }
 
+static auto test_masks_follow_assignments() -> supl::test_results
+{
+  supl::test_results results;
+
+  Sudoku incremental {get_legal_partial()};
+
+  const std::vector<Assignment> assignments {
+    {{0, 0}, '1'},
+    {{0, 4}, '2'},
+    {{4, 3}, '1'},
+    {{8, 8}, '9'},
+  };
+
+  for ( const Assignment& assignment : assignments ) {
+    results.enforce_true(incremental.try_assign(assignment),
+                         supl::to_string(assignment));
+
+    // freshly built from the raw cells
+    const Sudoku rebuilt {std::as_const(incremental).data()};
+
+    results.enforce_true(incremental.masks() == rebuilt.masks(),
+                         supl::to_string(assignment));
+    results.enforce_equal(incremental.query_domains(),
+                          rebuilt.query_domains(),
+                          supl::to_string(assignment));
+  }
+
+  // rejected assignment leaves masks untouched
+  const auto before {incremental.masks()};
+  results.enforce_false(incremental.try_assign({0, 2}, '1'));
+  results.enforce_true(incremental.masks() == before);
+
+  return results;
+}
+
+// straightforward occupancy masks to check the whole-board kernel against
+static auto reference_masks(const Sudoku& board) -> Sudoku::occupancy_masks
+{
+  Sudoku::occupancy_masks masks {};
+  std::array<unsigned, 27 * 9> counts {};
+
+  for ( const unsigned row : std::views::iota(0U, 9U) ) {
+    for ( const unsigned col : std::views::iota(0U, 9U) ) {
+      const char cell {board.data().at(row * 9 + col)};
+      if ( cell == '_' ) {
+        continue;
+      }
+
+      const auto digit {static_cast<unsigned>(cell - '1')};
+      const auto box {Sudoku::box_index({row, col})};
+      const auto bit {static_cast<std::uint16_t>(1U << digit)};
+
+      masks.rows.at(row) |= bit;
+      masks.cols.at(col) |= bit;
+      masks.boxes.at(box) |= bit;
+      ++masks.populated_count;
+
+      for ( const unsigned unit : {row, 9 + col, 18 + box} ) {
+        if ( ++counts.at(unit * 9 + digit) > 1 ) {
+          masks.has_conflict = true;
+        }
+      }
+    }
+  }
+
+  return masks;
+}
+
+static auto test_board_kernels_match_reference() -> supl::test_results
+{
+  supl::test_results results;
+
+  const Sudoku solved {
+    {
+     // clang-format off
+  '1', '9', '8', '5', '2', '6', '3', '4', '7',
+  '7', '2', '5', '3', '4', '1', '6', '9', '8',
+  '3', '4', '6', '9', '7', '8', '2', '1', '5',
+  '9', '8', '1', '2', '5', '7', '4', '6', '3',
+  '5', '6', '4', '1', '3', '9', '8', '7', '2',
+  '2', '3', '7', '6', '8', '4', '1', '5', '9',
+  '4', '7', '3', '8', '1', '5', '9', '2', '6',
+  '8', '1', '9', '7', '6', '2', '5', '3', '4',
+  '6', '5', '2', '4', '9', '3', '7', '8', '1'
+     // clang-format on
+    }
+  };
+
+  // fixed seed, so any failure reproduces
+  std::mt19937 engine {0x5EED};
+  std::uniform_int_distribution<unsigned> cell_dist {0, 80};
+  std::uniform_int_distribution<int> digit_dist {'1', '9'};
+  std::uniform_int_distribution<unsigned> count_dist {0, 60};
+
+  for ( const unsigned trial : std::views::iota(0U, 500U) ) {
+    Sudoku board {solved};
+
+    for ( [[maybe_unused]] const unsigned blank :
+          std::views::iota(0U, count_dist(engine)) ) {
+      const unsigned cell {cell_dist(engine)};
+      board.set_cell({cell / 9, cell % 9}, '_');
+    }
+
+    // every other board also gets a few random digits,
+    // which usually break a constraint
+    for ( [[maybe_unused]] const unsigned mutation :
+          std::views::iota(0U, trial % 2 * 3) ) {
+      const unsigned cell {cell_dist(engine)};
+      board.set_cell({cell / 9, cell % 9},
+                     static_cast<char>(digit_dist(engine)));
+    }
+
+    const auto expected {reference_masks(board)};
+
+    results.enforce_true(board.masks() == expected,
+                         supl::to_string(board.data()));
+    results.enforce_equal(
+      board.is_valid(), ! expected.has_conflict, supl::to_string(trial));
+
+    const auto all_candidates {board.all_candidates()};
+    for ( const unsigned row : std::views::iota(0U, 9U) ) {
+      for ( const unsigned col : std::views::iota(0U, 9U) ) {
+        results.enforce_equal(
+          all_candidates.at(row * 9 + col),
+          board.candidates({row, col}).to_ulong(),
+          supl::to_string(std::pair {trial, index_pair {row, col}}));
+      }
+    }
+  }
+
+  return results;
+}
+
 static auto constraint_checking() -> supl::test_section
 {
   supl::test_section section;
@@ -408,6 +546,10 @@ static auto constraint_checking() -> supl::test_section
   section.add_test("domain query - legal partial",
                    &test_query_legal_partial_domain);
   section.add_test("has_legal_assignments", &test_has_legal_assignments);
+  section.add_test("occupancy masks follow try_assign",
+                   &test_masks_follow_assignments);
+  section.add_test("whole-board kernels match reference",
+                   &test_board_kernels_match_reference);
 
   return section;
 }
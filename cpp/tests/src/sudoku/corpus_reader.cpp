@@ -0,0 +1,214 @@
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "corpus_reader.hpp"
+
+using namespace supl::literals::size_t_literal;
+
+// a copied block's text would point into the original's storage
+static_assert(! std::is_copy_constructible_v<corpus_block>);
+static_assert(! std::is_copy_assignable_v<corpus_block>);
+static_assert(std::is_nothrow_move_constructible_v<corpus_block>);
+static_assert(std::is_nothrow_move_assignable_v<corpus_block>);
+
+constexpr static std::string_view puzzle_line {
+  "7........6..41.25..13.95...86.......3.1...4.5.......86...84.53..42.36..7"
+  "........9"};
+
+// every line a reader hands out, checking each block's line count
+static auto read_lines(corpus_reader& reader,
+                       const std::size_t max_lines,
+                       supl::test_results& results)
+  -> std::vector<std::string>
+{
+  std::vector<std::string> lines;
+
+  for ( corpus_block block {reader.next_block(max_lines)};
+        ! block.text.empty();
+        block = reader.next_block(max_lines) ) {
+    std::size_t visited {0};
+    block.for_each_line([&](const std::string_view line) {
+      lines.emplace_back(line);
+      ++visited;
+    });
+
+    results.enforce_equal(visited, block.line_count);
+    results.enforce_true(block.line_count <= max_lines);
+  }
+
+  return lines;
+}
+
+// count distinct lines, each one tagged with its position
+static auto numbered_corpus(const std::size_t count) -> std::string
+{
+  std::string corpus;
+
+  for ( std::size_t i {0}; i < count; ++i ) {
+    corpus += puzzle_line;
+    corpus += supl::to_string(i);
+    corpus += '\n';
+  }
+
+  return corpus;
+}
+
+static auto numbered_lines(const std::size_t count)
+  -> std::vector<std::string>
+{
+  std::vector<std::string> lines;
+
+  for ( std::size_t i {0}; i < count; ++i ) {
+    lines.push_back(std::string {puzzle_line} + supl::to_string(i));
+  }
+
+  return lines;
+}
+
+static auto test_lines() -> supl::test_results
+{
+  supl::test_results results;
+
+  // blank lines, a carriage return, and no final newline
+  const std::string corpus {"first\n\n  \t\nsecond\r\n\nthird"};
+  const std::vector<std::string> expected {"first", "second\r", "third"};
+
+  for ( const std::size_t max_lines : {1_z, 2_z, 100_z} ) {
+    corpus_reader from_view {corpus};
+    results.enforce_true(read_lines(from_view, max_lines, results)
+                           == expected,
+                         "view");
+
+    std::istringstream stream {corpus};
+    corpus_reader from_stream {stream};
+    results.enforce_true(read_lines(from_stream, max_lines, results)
+                           == expected,
+                         "stream");
+  }
+
+  corpus_reader empty {std::string_view {}};
+  results.enforce_true(empty.next_block(10).text.empty());
+
+  return results;
+}
+
+static auto test_across_reads() -> supl::test_results
+{
+  supl::test_results results;
+
+  // many times what one read asks for, so lines are split between reads
+  const std::string corpus {numbered_corpus(5000)};
+
+  std::istringstream stream {corpus};
+  corpus_reader reader {stream};
+
+  results.enforce_true(read_lines(reader, 128, results)
+                       == numbered_lines(5000));
+  results.enforce_false(reader.failed());
+
+  return results;
+}
+
+static auto test_mapped_file() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::string path {"/tmp/corpus_reader_test_XXXXXX"};
+  const int descriptor {::mkstemp(path.data())};
+  results.enforce_true(descriptor >= 0);
+
+  const std::string corpus {numbered_corpus(1000)};
+  results.enforce_equal(
+    ::write(descriptor, corpus.data(), corpus.size()),
+    static_cast<ssize_t>(corpus.size()));
+  ::close(descriptor);
+
+  {
+    std::optional<corpus_reader> reader {
+      corpus_reader::open(path.c_str())};
+    results.enforce_true(reader.has_value());
+    results.enforce_true(reader->is_mapped());
+
+    // moving keeps the mapping, so earlier blocks stay valid
+    const corpus_block first {reader->next_block(10)};
+    corpus_reader moved {std::move(*reader)};
+
+    std::vector<std::string> lines;
+    first.for_each_line(
+      [&lines](const std::string_view line) { lines.emplace_back(line); });
+    for ( std::string& line : read_lines(moved, 100, results) ) {
+      lines.push_back(std::move(line));
+    }
+
+    results.enforce_true(lines == numbered_lines(1000));
+  }
+
+  std::remove(path.c_str());
+
+  results.enforce_false(
+    corpus_reader::open("/nonexistent/corpus.txt").has_value());
+
+  return results;
+}
+
+static auto test_pipe() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::array<int, 2> ends {};
+  results.enforce_equal(::pipe(ends.data()), 0);
+
+  // fits in the pipe's buffer, so needs no second thread
+  const std::string corpus {numbered_corpus(100)};
+  results.enforce_equal(::write(ends[1], corpus.data(), corpus.size()),
+                        static_cast<ssize_t>(corpus.size()));
+  ::close(ends[1]);
+
+  corpus_reader reader {corpus_reader::from_descriptor(ends[0])};
+  results.enforce_false(reader.is_mapped());
+  results.enforce_true(read_lines(reader, 7, results)
+                       == numbered_lines(100));
+  results.enforce_false(reader.failed());
+
+  ::close(ends[0]);
+
+  return results;
+}
+
+static auto corpus_reader_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("lines", &test_lines);
+  section.add_test("lines across reads", &test_across_reads);
+  section.add_test("mapped file", &test_mapped_file);
+  section.add_test("pipe", &test_pipe);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(corpus_reader_tests());
+
+  return runner.run();
+}
@@ -0,0 +1,140 @@
+#include <array>
+#include <ranges>
+#include <utility>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "exact_cover.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+static auto get_evil() -> const Sudoku&
+{
+  static const Sudoku evil {
+    {
+     // clang-format off
+'_', '6', '_', '8', '_', '_', '_', '_', '_',
+'_', '_', '4', '_', '6', '_', '_', '_', '9',
+'1', '_', '_', '_', '4', '3', '_', '6', '_',
+'_', '5', '2', '_', '_', '_', '_', '_', '_',
+'_', '_', '8', '6', '_', '9', '3', '_', '_',
+'_', '_', '_', '_', '_', '_', '5', '7', '_',
+'_', '1', '_', '4', '8', '_', '_', '_', '5',
+'8', '_', '_', '_', '1', '_', '2', '_', '_',
+'_', '_', '_', '_', '_', '5', '_', '4', '_',
+     // clang-format on
+    }
+  };
+
+  return evil;
+}
+
+static auto test_matches_backtracking() -> supl::test_results
+{
+  supl::test_results results;
+
+  Sudoku backtracked {get_evil()};
+  results.enforce_true(backtracked
+                         .solve(&hidden_single_optimization,
+                                &minimum_remaining_values_selection)
+                         .second);
+
+  exact_cover_solver solver {};
+  Sudoku exact {get_evil()};
+  const auto [row_count, solved] {solver.solve(exact)};
+
+  results.enforce_true(solved);
+  results.enforce_true(row_count > 0);
+  results.enforce_true(exact.is_solved());
+  results.enforce_equal(exact, backtracked);
+
+  // solver is reusable
+  Sudoku again {get_evil()};
+  results.enforce_true(solver.solve(again).second);
+  results.enforce_equal(again, exact);
+
+  return results;
+}
+
+static auto test_degenerate_boards() -> supl::test_results
+{
+  supl::test_results results;
+
+  exact_cover_solver solver {};
+
+  std::array<char, 81> blank {};
+  blank.fill('_');
+
+  Sudoku empty {blank};
+  results.enforce_true(solver.solve(empty).second);
+  results.enforce_true(empty.is_solved());
+
+  // already solved board is untouched, no rows need trying
+  const Sudoku solved_board {empty};
+  const auto [row_count, solved] {solver.solve(empty)};
+  results.enforce_true(solved);
+  results.enforce_equal(row_count, std::size_t {0});
+  results.enforce_equal(empty, solved_board);
+
+  // board with a duplicate is rejected outright
+  Sudoku invalid {blank};
+  invalid.set_cell({0, 0}, '5');
+  invalid.set_cell({0, 1}, '5');
+  const Sudoku invalid_copy {invalid};
+  results.enforce_false(solver.solve(invalid).second);
+  results.enforce_equal(invalid, invalid_copy);
+
+  return results;
+}
+
+static auto test_impossible() -> supl::test_results
+{
+  supl::test_results results;
+
+  const Sudoku impossible {
+    {
+     // clang-format off
+'7', '3', '2', '1', '8', '_', '4', '9', '6',
+'5', '6', '_', '2', '9', '4', '7', '1', '3',
+'8', '1', '4', '3', '6', '_', '5', '2', '_',
+'3', '7', '5', '9', '1', '2', '8', '_', '4',
+'4', '2', '6', '8', '7', '5', '1', '3', '9',
+'1', '9', '8', '4', '3', '_', '6', '5', '7',
+'6', '5', '3', '_', '2', '7', '9', '4', '1',
+'9', '4', '1', '6', '5', '3', '_', '7', '2',
+'2', '8', '_', '_', '4', '_', '3', '6', '5',
+     // clang-format on
+    }
+  };
+
+  exact_cover_solver solver {};
+  Sudoku board {impossible};
+
+  results.enforce_false(solver.solve(board).second);
+  results.enforce_equal(board, impossible);
+
+  return results;
+}
+
+static auto exact_cover_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("agrees with backtracking",
+                   &test_matches_backtracking);
+  section.add_test("degenerate boards", &test_degenerate_boards);
+  section.add_test("impossible board", &test_impossible);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(exact_cover_tests());
+
+  return runner.run();
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "generator.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+static auto count_clues(const Sudoku& puzzle) -> std::size_t
+{
+  return static_cast<std::size_t>(std::ranges::count_if(
+    puzzle.data(), [](const char cell) { return cell != '_'; }));
+}
+
+static auto is_clue(const Sudoku& puzzle,
+                    const unsigned row,
+                    const unsigned col) -> bool
+{
+  return puzzle.data().at(row * 9 + col) != '_';
+}
+
+static auto test_unique() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  std::mt19937_64 rng {42};
+
+  for ( int i {0}; i < 20; ++i ) {
+    const Sudoku puzzle {generate_puzzle(rng, {})};
+
+    results.enforce_true(puzzle.is_valid());
+    results.enforce_equal(
+      puzzle
+        .count_solutions(&hidden_single_optimization,
+                         &minimum_remaining_values_selection,
+                         0)
+        .second,
+      1_z,
+      "unique");
+  }
+
+  return results;
+}
+
+static auto test_clue_target() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  std::mt19937_64 rng {42};
+
+  // comfortably above the fewest clues possible, so always reached
+  for ( const std::size_t target : {30_z, 40_z, 60_z} ) {
+    const Sudoku puzzle {generate_puzzle(rng, {target})};
+
+    results.enforce_equal(count_clues(puzzle), target);
+    results.enforce_equal(
+      puzzle
+        .count_solutions(&hidden_single_optimization,
+                         &minimum_remaining_values_selection,
+                         2)
+        .second,
+      1_z,
+      "unique");
+  }
+
+  return results;
+}
+
+static auto test_symmetry() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::mt19937_64 rng {42};
+
+  const Sudoku rotational {
+    generate_puzzle(rng, {.pattern = symmetry::rotational})};
+  const Sudoku mirror {generate_puzzle(rng, {.pattern = symmetry::mirror})};
+  const Sudoku diagonal {
+    generate_puzzle(rng, {.pattern = symmetry::diagonal})};
+  const Sudoku dihedral {
+    generate_puzzle(rng, {.pattern = symmetry::dihedral})};
+
+  for ( unsigned row {0}; row < 9; ++row ) {
+    for ( unsigned col {0}; col < 9; ++col ) {
+      results.enforce_equal(is_clue(rotational, row, col),
+                            is_clue(rotational, 8 - row, 8 - col));
+      results.enforce_equal(is_clue(mirror, row, col),
+                            is_clue(mirror, row, 8 - col));
+      results.enforce_equal(is_clue(diagonal, row, col),
+                            is_clue(diagonal, col, row));
+      results.enforce_equal(is_clue(dihedral, row, col),
+                            is_clue(dihedral, col, 8 - row));
+      results.enforce_equal(is_clue(dihedral, row, col),
+                            is_clue(dihedral, row, 8 - col));
+    }
+  }
+
+  return results;
+}
+
+static auto test_reproducible() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  std::mt19937_64 first_rng {7};
+  std::mt19937_64 second_rng {7};
+  results.enforce_equal(generate_puzzle(first_rng, {}),
+                        generate_puzzle(second_rng, {}));
+
+  // spans several chunks, which threads may finish in any order
+  const generator_options options {.pattern = symmetry::rotational};
+
+  std::ostringstream one_thread;
+  const generation_report report {
+    generate_batch(one_thread, 150, 7, options, 1)};
+
+  std::ostringstream three_threads;
+  static_cast<void>(generate_batch(three_threads, 150, 7, options, 3));
+
+  results.enforce_equal(report.puzzle_count, 150_z);
+  results.enforce_equal(
+    static_cast<std::size_t>(std::ranges::count(one_thread.str(), '\n')),
+    150_z);
+  results.enforce_equal(one_thread.str(), three_threads.str());
+
+  std::ostringstream other_seed;
+  static_cast<void>(generate_batch(other_seed, 150, 8, options, 1));
+  results.enforce_true(one_thread.str() != other_seed.str());
+
+  // every line is a puzzle
+  std::istringstream lines {one_thread.str()};
+  std::string line;
+  while ( std::getline(lines, line) ) {
+    results.enforce_true(Sudoku::from_line(line).has_value());
+  }
+
+  return results;
+}
+
+static auto test_parse_symmetry() -> supl::test_results
+{
+  supl::test_results results;
+
+  results.enforce_true(parse_symmetry("none") == symmetry::none);
+  results.enforce_true(parse_symmetry("dihedral") == symmetry::dihedral);
+  results.enforce_false(parse_symmetry("sideways").has_value());
+
+  return results;
+}
+
+static auto generator_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("unique solution", &test_unique);
+  section.add_test("clue target", &test_clue_target);
+  section.add_test("symmetry", &test_symmetry);
+  section.add_test("reproducible from seed", &test_reproducible);
+  section.add_test("parse symmetry", &test_parse_symmetry);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(generator_tests());
+
+  return runner.run();
+}
@@ -35,12 +35,13 @@ auto main() -> int
 
   results.enforce_equal(data_view(8, 8), '1');
 
-  data_view(1, 1) = '4';
+  // the view follows writes made through the board
+  test.set_cell({1, 1}, '4');
 
   results.enforce_equal(data_view(1, 1), '4');
 
-  // better not compile
-  /* auto const_view = std::as_const(test).mdview(); */
+  // no view of a board may write to it, so this had better not compile
+  /* auto const_view = test.mdview(); */
   /* const_view(3, 5) = '8'; */
   // and does not! :)
 
@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ios>
+#include <optional>
+#include <random>
+#include <streambuf>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "corpus_reader.hpp"
+#include "packed_corpus.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+using namespace supl::literals::size_t_literal;
+
+constexpr static std::string_view hard_line {
+  "7........6..41.25..13.95...86.......3.1...4.5......."
+  "86...84.53..42.36..7........9"};
+
+constexpr static std::string_view hard_solution {
+  "72536819468941725341329576886795432139168247525417398"
+  "6176849532942536817538721649"};
+
+// puzzles made by blanking cells of one solution at random,
+// so that every one agrees with it
+static auto blanked_puzzles(const std::size_t count)
+  -> std::vector<Sudoku>
+{
+  std::mt19937 rng {2024};
+  std::vector<Sudoku> puzzles;
+
+  for ( std::size_t i {0}; i < count; ++i ) {
+    std::string line {hard_solution};
+    // from every cell blank to none, to cover the extremes
+    const std::size_t keep {rng() % 82};
+    for ( char& cell : line ) {
+      if ( rng() % 81 >= keep ) {
+        cell = '_';
+      }
+    }
+    puzzles.push_back(*Sudoku::from_line(line));
+  }
+
+  return puzzles;
+}
+
+static auto pack(const std::vector<Sudoku>& puzzles,
+                 const bool with_solutions) -> std::string
+{
+  const Sudoku solution {*Sudoku::from_line(hard_solution)};
+
+  std::ostringstream out;
+  packed_corpus_writer writer {out, with_solutions};
+
+  for ( std::size_t i {0}; i < puzzles.size(); ++i ) {
+    // every third one left unsolved
+    writer.add(puzzles[i],
+               i % 3 == 0 ? std::nullopt : std::optional {solution});
+  }
+
+  writer.finish();
+  return std::move(out).str();
+}
+
+static auto test_crc32() -> supl::test_results
+{
+  supl::test_results results;
+
+  // the standard check value
+  results.enforce_equal(crc32("123456789"), std::uint32_t {0xCBF43926});
+  results.enforce_equal(crc32(""), std::uint32_t {0});
+
+  return results;
+}
+
+static auto test_round_trip() -> supl::test_results
+{
+  supl::test_results results;
+
+  // enough for a partly filled last block
+  const std::vector<Sudoku> puzzles {blanked_puzzles(2500)};
+  const Sudoku solution {*Sudoku::from_line(hard_solution)};
+
+  for ( const bool with_solutions : {false, true} ) {
+    const std::string bytes {pack(puzzles, with_solutions)};
+    const auto corpus {packed_corpus::from_bytes(bytes)};
+
+    results.enforce_true(corpus.has_value());
+    results.enforce_equal(corpus->size(), puzzles.size());
+    results.enforce_equal(corpus->has_solutions(), with_solutions);
+    results.enforce_equal(corpus->block_count(), 3_z);
+
+    for ( std::size_t block {0}; block < corpus->block_count(); ++block ) {
+      results.enforce_true(corpus->verify_block(block));
+    }
+
+    // backwards, as random access needs no earlier record
+    for ( std::size_t i {puzzles.size()}; i-- > 0; ) {
+      const auto entry {corpus->at(i)};
+      results.enforce_true(entry.has_value());
+      results.enforce_true(entry->puzzle == puzzles[i]);
+      // a full grid has nothing left to store, so is its own solution
+      const bool is_full {puzzles[i] == solution};
+      results.enforce_true(
+        entry->solution
+        == (with_solutions && (i % 3 != 0 || is_full)
+              ? std::optional {solution}
+              : std::nullopt));
+    }
+
+    results.enforce_false(corpus->at(puzzles.size()).has_value());
+  }
+
+  // nothing at all is still a corpus
+  const auto empty {packed_corpus::from_bytes(pack({}, false))};
+  results.enforce_true(empty.has_value());
+  results.enforce_equal(empty->size(), 0_z);
+  results.enforce_equal(empty->block_count(), 0_z);
+
+  return results;
+}
+
+static auto test_size() -> supl::test_results
+{
+  supl::test_results results;
+
+  const Sudoku hard {*Sudoku::from_line(hard_line)};
+
+  // the header, a block of one, an index entry, and the trailer
+  constexpr std::size_t overhead {packed_format::header_size + 4
+                                  + packed_format::index_entry_size
+                                  + packed_format::trailer_size};
+
+  // the clue map, then 28 clues at 4 bits each
+  results.enforce_equal(pack({hard}, false).size(), overhead + 11 + 14);
+  results.enforce_equal(pack({hard, hard}, true).size(),
+                        overhead + 2 + 2 * packed_format::max_record_size);
+
+  return results;
+}
+
+static auto test_damage() -> supl::test_results
+{
+  supl::test_results results;
+
+  const std::vector<Sudoku> puzzles {blanked_puzzles(2500)};
+  const std::string bytes {pack(puzzles, true)};
+
+  // a flipped bit in the middle of the second block
+  std::string damaged {bytes};
+  damaged.at(packed_format::header_size + bytes.size() / 2) ^= 0x10;
+
+  const auto corpus {packed_corpus::from_bytes(damaged)};
+  results.enforce_true(corpus.has_value());
+  results.enforce_true(corpus->verify_block(0));
+  results.enforce_false(corpus->verify_block(1));
+  results.enforce_true(corpus->verify_block(2));
+  results.enforce_false(corpus->verify_block(3));
+
+  std::ostringstream out;
+  const batch_report report {unpack_corpus(*corpus, out, false)};
+  results.enforce_equal(report.failure_count,
+                        packed_format::block_capacity);
+  results.enforce_equal(
+    out.str().size(),
+    (puzzles.size() - packed_format::block_capacity) * 82);
+
+  // anything cut short, or not a corpus at all, is refused
+  results.enforce_false(
+    packed_corpus::from_bytes(std::string_view {bytes}.substr(
+                                0, bytes.size() - 1))
+      .has_value());
+  results.enforce_false(
+    packed_corpus::from_bytes(std::string_view {bytes}.substr(1))
+      .has_value());
+  results.enforce_false(packed_corpus::from_bytes(hard_line).has_value());
+
+  std::string bad_count {bytes};
+  // claims more puzzles than the index has blocks for
+  bad_count.at(bytes.size() - 15) = 0x20;
+  results.enforce_false(packed_corpus::from_bytes(bad_count).has_value());
+
+  return results;
+}
+
+static auto test_text_conversion() -> supl::test_results
+{
+  supl::test_results results;
+
+  const std::string impossible {
+    "11" + std::string {hard_line.substr(2)}};
+  const std::string text {std::string {hard_line} + "\n"
+                          + "not a puzzle\n\n" + impossible + "\n"
+                          + std::string {hard_solution} + "\n"};
+
+  corpus_reader in {text};
+  std::ostringstream packed;
+  const batch_report packed_report {
+    pack_corpus(in, packed, find_strategy("--hidden"))};
+
+  // the bad line is dropped, the impossible one kept unsolved
+  results.enforce_equal(packed_report.puzzle_count, 4_z);
+  results.enforce_equal(packed_report.failure_count, 2_z);
+
+  const std::string bytes {std::move(packed).str()};
+  const auto corpus {packed_corpus::from_bytes(bytes)};
+  results.enforce_true(corpus.has_value());
+  results.enforce_equal(corpus->size(), 3_z);
+
+  std::string hard_blanks {hard_line};
+  std::ranges::replace(hard_blanks, '.', '_');
+  std::string impossible_blanks {impossible};
+  std::ranges::replace(impossible_blanks, '.', '_');
+
+  std::ostringstream puzzles;
+  results.enforce_equal(
+    unpack_corpus(*corpus, puzzles, false).failure_count, 0_z);
+  results.enforce_equal(puzzles.str(),
+                        hard_blanks + "\n" + impossible_blanks + "\n"
+                          + std::string {hard_solution} + "\n");
+
+  // a puzzle without a solution is marked as solve_batch marks it
+  std::ostringstream solutions;
+  results.enforce_equal(
+    unpack_corpus(*corpus, solutions, true).failure_count, 1_z);
+  results.enforce_equal(solutions.str(),
+                        std::string {hard_solution} + "\n"
+                          + std::string {batch_failure_prefix}
+                          + impossible_blanks + "\n"
+                          + std::string {hard_solution} + "\n");
+
+  return results;
+}
+
+// takes the header, then fails every later write
+class full_buffer : public std::streambuf
+{
+private:
+
+  std::array<char, 64> m_bytes {};
+
+public:
+
+  full_buffer()
+  {
+    this->setp(m_bytes.data(), m_bytes.data() + m_bytes.size());
+  }
+};
+
+static auto test_failed_writes() -> supl::test_results
+{
+  supl::test_results results;
+
+  const Sudoku puzzle {*Sudoku::from_line(hard_line)};
+
+  // left for the destructor, which must not throw
+  full_buffer abandoned_buffer {};
+  std::ostream abandoned {&abandoned_buffer};
+  abandoned.exceptions(std::ios::badbit);
+  {
+    packed_corpus_writer writer {abandoned, false};
+    writer.add(puzzle);
+  }
+  results.enforce_true(abandoned.bad());
+
+  // finish reports it
+  full_buffer finished_buffer {};
+  std::ostream finished {&finished_buffer};
+  finished.exceptions(std::ios::badbit);
+  packed_corpus_writer writer {finished, false};
+  writer.add(puzzle);
+
+  bool threw {false};
+  try {
+    writer.finish();
+  } catch ( const std::ios_base::failure& ) {
+    threw = true;
+  }
+  results.enforce_true(threw);
+
+  return results;
+}
+
+static auto test_mapped_file() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::string path {"/tmp/packed_corpus_test_XXXXXX"};
+  const int descriptor {::mkstemp(path.data())};
+  results.enforce_true(descriptor >= 0);
+
+  const std::vector<Sudoku> puzzles {blanked_puzzles(100)};
+  const std::string bytes {pack(puzzles, false)};
+  results.enforce_equal(::write(descriptor, bytes.data(), bytes.size()),
+                        static_cast<ssize_t>(bytes.size()));
+  ::close(descriptor);
+
+  {
+    std::optional<packed_corpus> corpus {
+      packed_corpus::open(path.c_str())};
+    results.enforce_true(corpus.has_value());
+
+    // moving keeps the mapping
+    const packed_corpus moved {std::move(*corpus)};
+    results.enforce_equal(moved.size(), puzzles.size());
+    results.enforce_true(moved.verify_block(0));
+    results.enforce_true(moved.at(42)->puzzle == puzzles[42]);
+  }
+
+  std::remove(path.c_str());
+
+  results.enforce_false(
+    packed_corpus::open("/nonexistent/corpus.pk").has_value());
+
+  return results;
+}
+
+static auto packed_corpus_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("crc32", &test_crc32);
+  section.add_test("round trip", &test_round_trip);
+  section.add_test("record size", &test_size);
+  section.add_test("damage is caught", &test_damage);
+  section.add_test("text conversion", &test_text_conversion);
+  section.add_test("mapped file", &test_mapped_file);
+  section.add_test("failed writes", &test_failed_writes);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(packed_corpus_tests());
+
+  return runner.run();
+}
@@ -0,0 +1,170 @@
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "parallel_solve.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+static auto get_hard() -> const Sudoku&
+{
+  static const Sudoku hard {
+    {
+     // clang-format off
+'7', '_', '_', '_', '_', '_', '_', '_', '_',
+'6', '_', '_', '4', '1', '_', '2', '5', '_',
+'_', '1', '3', '_', '9', '5', '_', '_', '_',
+'8', '6', '_', '_', '_', '_', '_', '_', '_',
+'3', '_', '1', '_', '_', '_', '4', '_', '5',
+'_', '_', '_', '_', '_', '_', '_', '8', '6',
+'_', '_', '_', '8', '4', '_', '5', '3', '_',
+'_', '4', '2', '_', '3', '6', '_', '_', '7',
+'_', '_', '_', '_', '_', '_', '_', '_', '9',
+     // clang-format on
+    }
+  };
+
+  return hard;
+}
+
+struct strategy {
+  std::add_pointer_t<std::size_t(solver_state&)> optimization;
+  std::add_pointer_t<index_pair(const solver_state&)> selection;
+};
+
+constexpr static std::array strategies {
+  strategy {&null_optimization, &first_unassigned_selection},
+  strategy {&trivial_move_optimization,
+            &minimum_remaining_values_selection},
+};
+
+// a threshold of 0 splits the search straight away
+constexpr static std::array thresholds {
+  std::size_t {0}, std::size_t {4}, parallel_branch_threshold};
+
+static auto test_matches_sequential() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  for ( const auto& [optimization, selection] : strategies ) {
+    Sudoku expected {get_hard()};
+    results.enforce_true(expected.solve(optimization, selection).second);
+
+    for ( const std::size_t threshold : thresholds ) {
+      for ( const std::size_t thread_count : {1_z, 2_z, 4_z} ) {
+        Sudoku board {get_hard()};
+
+        const auto [assignment_count, solved] {solve_parallel(
+          board, optimization, selection, thread_count, threshold)};
+
+        results.enforce_true(solved);
+        results.enforce_true(assignment_count > 0);
+        // the puzzle has a unique solution
+        results.enforce_equal(board, expected);
+      }
+    }
+  }
+
+  return results;
+}
+
+static auto test_impossible() -> supl::test_results
+{
+  supl::test_results results;
+
+  const Sudoku impossible {
+    {
+     // clang-format off
+'7', '3', '2', '1', '8', '_', '4', '9', '6',
+'5', '6', '_', '2', '9', '4', '7', '1', '3',
+'8', '1', '4', '3', '6', '_', '5', '2', '_',
+'3', '7', '5', '9', '1', '2', '8', '_', '4',
+'4', '2', '6', '8', '7', '5', '1', '3', '9',
+'1', '9', '8', '4', '3', '_', '6', '5', '7',
+'6', '5', '3', '_', '2', '7', '9', '4', '1',
+'9', '4', '1', '6', '5', '3', '_', '7', '2',
+'2', '8', '_', '_', '4', '_', '3', '6', '5',
+     // clang-format on
+    }
+  };
+
+  for ( const auto& [optimization, selection] : strategies ) {
+    for ( const std::size_t threshold : thresholds ) {
+      Sudoku board {impossible};
+
+      results.enforce_false(
+        solve_parallel(board, optimization, selection, 4, threshold)
+          .second);
+      results.enforce_equal(board, impossible);
+    }
+  }
+
+  return results;
+}
+
+// With no solution, every subtree is searched to the end,
+// so splitting the search must add no work to it
+static auto test_no_repeated_work() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  // a 1 in the bottom left corner, where its solution has a 4,
+  // is only found out after thousands of branches
+  Sudoku unsolvable {get_hard()};
+  results.enforce_true(unsolvable.try_assign({8, 0}, '1'));
+
+  for ( const auto& [optimization, selection] : strategies ) {
+    Sudoku sequential_board {unsolvable};
+    const auto [expected_count, sequential_solved] {
+      sequential_board.solve(optimization, selection)};
+    results.enforce_false(sequential_solved);
+
+    for ( const std::size_t threshold : thresholds ) {
+      for ( const std::size_t thread_count : {2_z, 4_z} ) {
+        Sudoku board {unsolvable};
+
+        const auto [assignment_count, solved] {solve_parallel(
+          board, optimization, selection, thread_count, threshold)};
+
+        results.enforce_false(solved);
+        results.enforce_equal(assignment_count,
+                              expected_count,
+                              supl::to_string(threshold));
+      }
+    }
+  }
+
+  return results;
+}
+
+static auto parallel_solve_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("parallel solve matches sequential",
+                   &test_matches_sequential);
+  section.add_test("parallel solve impossible board", &test_impossible);
+  section.add_test("parallel solve repeats no work",
+                   &test_no_repeated_work);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(parallel_solve_tests());
+
+  return runner.run();
+}
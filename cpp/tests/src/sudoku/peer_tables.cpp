@@ -0,0 +1,106 @@
+#include <array>
+#include <cstdint>
+#include <ranges>
+#include <utility>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "peer_tables.hpp"
+
+static auto test_cell_positions() -> supl::test_results
+{
+  supl::test_results results;
+
+  for ( const unsigned row : std::views::iota(0U, 9U) ) {
+    for ( const unsigned col : std::views::iota(0U, 9U) ) {
+      const unsigned cell {row * 9 + col};
+
+      results.enforce_equal(cell_positions.rows.at(cell), row);
+      results.enforce_equal(cell_positions.cols.at(cell), col);
+      results.enforce_equal(cell_positions.boxes.at(cell),
+                            (row / 3) * 3 + col / 3,
+                            supl::to_string(cell));
+    }
+  }
+
+  return results;
+}
+
+static auto test_unit_cells() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::array<unsigned, 81> unit_count {};
+
+  for ( const unsigned unit : std::views::iota(0U, 27U) ) {
+    for ( const std::uint8_t cell : unit_cells.at(unit) ) {
+      ++unit_count.at(cell);
+
+      // every cell of the unit is in the unit's row, column, or box
+      const unsigned position {unit < 9    ? cell_positions.rows.at(cell)
+                               : unit < 18 ? cell_positions.cols.at(cell)
+                                           : cell_positions.boxes.at(cell)};
+      results.enforce_equal(
+        position, unit % 9, supl::to_string(std::pair {unit, cell}));
+    }
+  }
+
+  // every cell is in exactly one row, column, and box
+  for ( const unsigned count : unit_count ) {
+    results.enforce_equal(count, 3U);
+  }
+
+  return results;
+}
+
+static auto test_cell_peers() -> supl::test_results
+{
+  supl::test_results results;
+
+  for ( const unsigned cell : std::views::iota(0U, 81U) ) {
+    std::array<bool, 81> is_peer {};
+
+    for ( const std::uint8_t peer : cell_peers.at(cell) ) {
+      results.enforce_false(is_peer.at(peer), "peer listed twice");
+      is_peer.at(peer) = true;
+    }
+
+    for ( const unsigned other : std::views::iota(0U, 81U) ) {
+      const bool shares_unit {
+        other != cell
+        && (cell / 9 == other / 9 || cell % 9 == other % 9
+            || ((cell / 27) == (other / 27)
+                && (cell % 9) / 3 == (other % 9) / 3))};
+
+      results.enforce_equal(is_peer.at(other),
+                            shares_unit,
+                            supl::to_string(std::pair {cell, other}));
+    }
+  }
+
+  return results;
+}
+
+static auto peer_tables() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("cell positions", &test_cell_positions);
+  section.add_test("unit cells", &test_unit_cells);
+  section.add_test("cell peers", &test_cell_peers);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(peer_tables());
+
+  return runner.run();
+}
@@ -0,0 +1,231 @@
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "batch.hpp"
+#include "corpus_reader.hpp"
+#include "rater.hpp"
+#include "solver_state.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+// inputs/easy.dat, which naked singles alone finish
+constexpr static std::string_view easy_puzzle {
+  "_3__8___65__29471____3__5____5_1_8_442_8_5_391_8_3_6____3__7___"
+  "_41653__22___4__6_"};
+
+constexpr static std::string_view medium_puzzle {
+  "_4_____696__1_______8_9___3____5_8___15__4_7_47_______5___3_1_4_"
+  "____6____3____72_"};
+
+// inputs/evil.dat
+constexpr static std::string_view hard_puzzle {
+  "_6_8_______4_6___91___43_6__52________86_93________57__1_48___58"
+  "___1_2_______5_4_"};
+
+constexpr static std::string_view search_puzzle {
+  "___359________4___5__18_43____973__1_______8____8___23_47____6__"
+  "65_9___78_____1__"};
+
+static auto rate_line(const std::string_view line) -> difficulty_rating
+{
+  return rate(*Sudoku::from_line(line));
+}
+
+static auto test_tiers() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  const difficulty_rating easy {rate_line(easy_puzzle)};
+  results.enforce_true(easy.solved_logically());
+  results.enforce_equal(difficulty_tier(easy), std::string_view {"easy"});
+  results.enforce_true(easy.hardest == technique::naked_single);
+  results.enforce_equal(
+    easy.uses.at(static_cast<std::size_t>(technique::naked_single)),
+    45_z);
+
+  const difficulty_rating medium {rate_line(medium_puzzle)};
+  results.enforce_true(medium.solved_logically());
+  results.enforce_equal(difficulty_tier(medium),
+                        std::string_view {"medium"});
+
+  const difficulty_rating hard {rate_line(hard_puzzle)};
+  results.enforce_true(hard.solved_logically());
+  results.enforce_equal(difficulty_tier(hard), std::string_view {"hard"});
+  results.enforce_true(hard.hardest == technique::naked_pair);
+
+  const difficulty_rating search {rate_line(search_puzzle)};
+  results.enforce_true(search.consistent);
+  results.enforce_false(search.solved_logically());
+  results.enforce_equal(difficulty_tier(search),
+                        std::string_view {"search"});
+  results.enforce_equal(search.cells_left, 25_z);
+  results.enforce_true(search.search_space_bits > 0);
+
+  return results;
+}
+
+static auto test_invalid() -> supl::test_results
+{
+  supl::test_results results;
+
+  // two 1s in the first row
+  const difficulty_rating duplicate {rate_line(
+    "11_______________________________________________________________"
+    "________________")};
+  results.enforce_false(duplicate.consistent);
+  results.enforce_equal(difficulty_tier(duplicate),
+                        std::string_view {"invalid"});
+
+  // the last cell of the first row can only be 9,
+  // which its column already has
+  const difficulty_rating unsolvable {rate_line(
+    "12345678_________9_______________________________________________"
+    "________________")};
+  results.enforce_false(unsolvable.consistent);
+  results.enforce_equal(difficulty_tier(unsolvable),
+                        std::string_view {"invalid"});
+
+  return results;
+}
+
+static auto test_rate_state() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  const Sudoku puzzle {*Sudoku::from_line(search_puzzle)};
+  solver_state state {puzzle};
+  const difficulty_rating rating {rate(state)};
+
+  // the same rating, with the deductions left in state
+  const difficulty_rating fresh {rate(puzzle)};
+  results.enforce_equal(rating.cells_left, fresh.cells_left);
+  results.enforce_true(rating.hardest == fresh.hardest);
+  results.enforce_equal(
+    81_z - state.board().masks().populated_count, rating.cells_left);
+
+  Sudoku expected {puzzle};
+  solver_context context {};
+
+  for ( const search_strategy& strategy : search_strategies ) {
+    const std::string flag {strategy.flag};
+    static_cast<void>(context.solve(expected, strategy));
+
+    // carrying on from the rating reaches the same solution
+    solver_state rated {puzzle};
+    static_cast<void>(rate(rated));
+    Sudoku solution {};
+    results.enforce_true(context.solve(rated, strategy, solution).second,
+                         flag);
+    results.enforce_true(solution == expected, flag);
+  }
+
+  return results;
+}
+
+static auto test_technique_names() -> supl::test_results
+{
+  supl::test_results results;
+
+  results.enforce_equal(technique_name(technique::naked_single),
+                        std::string_view {"naked single"});
+  results.enforce_equal(technique_name(technique::locked_candidates),
+                        std::string_view {"locked candidates"});
+  results.enforce_equal(technique_name(technique::hidden_quad),
+                        std::string_view {"hidden quad"});
+
+  return results;
+}
+
+static auto test_rate_batch() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  const std::string corpus {std::string {easy_puzzle}
+                            + "\nnot a puzzle\n"
+                            + std::string {search_puzzle} + '\n'};
+
+  corpus_reader in {corpus};
+  std::ostringstream out;
+
+  const batch_report report {rate_batch(in, out, 1)};
+
+  results.enforce_equal(report.puzzle_count, 3_z);
+  results.enforce_equal(report.failure_count, 1_z);
+  results.enforce_equal(
+    out.str(),
+    std::string {easy_puzzle} + "\teasy\tnaked single\t0\t0.0\n"
+      + "not a puzzle\tinvalid\tnone\t0\t0.0\n"
+      + std::string {search_puzzle}
+      + "\tsearch\tnaked triple\t25\t28.3\n");
+
+  // the same lines, in the same order, from a pool
+  corpus_reader parallel_in {corpus};
+  std::ostringstream parallel_out;
+  static_cast<void>(rate_batch(parallel_in, parallel_out, 3));
+  results.enforce_equal(parallel_out.str(), out.str());
+
+  // and solved from where the rating left off
+  const search_strategy* const strategy {find_strategy("--hidden")};
+
+  if ( strategy == nullptr ) {
+    results.enforce_true(false, "no --hidden strategy");
+    return results;
+  }
+
+  Sudoku solution {*Sudoku::from_line(search_puzzle)};
+  solver_context context {};
+  static_cast<void>(context.solve(solution, *strategy));
+  std::string solution_line(Sudoku::cell_count, '_');
+  solution.format_line(solution_line.data());
+
+  corpus_reader solve_in {corpus};
+  std::ostringstream solve_out;
+  const batch_report solve_report {
+    rate_batch(solve_in, solve_out, 1, strategy)};
+
+  const std::string solved {solve_out.str()};
+  results.enforce_equal(solve_report.failure_count, 1_z);
+  results.enforce_equal(
+    solved.substr(solved.find("not a puzzle")),
+    std::string {"not a puzzle\tinvalid\tnone\t0\t0.0\tnone\n"}
+      + std::string {search_puzzle}
+      + "\tsearch\tnaked triple\t25\t28.3\t" + solution_line + '\n');
+
+  return results;
+}
+
+static auto rater_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("difficulty tiers", &test_tiers);
+  section.add_test("invalid puzzles", &test_invalid);
+  section.add_test("rating a solver state", &test_rate_state);
+  section.add_test("technique names", &test_technique_names);
+  section.add_test("rate_batch", &test_rate_batch);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(rater_tests());
+
+  return runner.run();
+}
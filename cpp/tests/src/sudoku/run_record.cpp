@@ -0,0 +1,167 @@
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "run_record.hpp"
+#include "search_stats.hpp"
+
+static auto sample_record() -> run_record
+{
+  run_record record {};
+  record.command = "./sudoku_solver --hidden ../inputs/evil.dat";
+  record.alg = "hidden";
+  record.puzzle = "evil";
+  record.input_path = "../inputs/evil.dat";
+  record.solved = true;
+  record.assignment_count = 74;
+  record.solution = "1234";
+  record.elapsed = std::chrono::nanoseconds {1'000'123'456};
+  record.user_time = std::chrono::microseconds {120};
+  record.system_time = std::chrono::nanoseconds {0};
+  return record;
+}
+
+static auto test_puzzle_name() -> supl::test_results
+{
+  supl::test_results results;
+
+  results.enforce_equal(puzzle_name("../inputs/evil.dat"),
+                        std::string {"evil"});
+  results.enforce_equal(puzzle_name("evil.dat"), std::string {"evil"});
+  results.enforce_equal(puzzle_name("inputs/16x16"),
+                        std::string {"16x16"});
+  results.enforce_equal(puzzle_name("/tmp/.hidden"),
+                        std::string {".hidden"});
+  results.enforce_equal(puzzle_name("a.b/c.d.dat"), std::string {"c.d"});
+
+  return results;
+}
+
+static auto test_json() -> supl::test_results
+{
+  supl::test_results results;
+
+  run_record record {sample_record()};
+
+  std::ostringstream out;
+  write_json(out, record);
+  results.enforce_equal(
+    out.str(),
+    std::string {
+      "{\n"
+      "  \"results\": [\n"
+      "    {\n"
+      "      \"command\": "
+      "\"./sudoku_solver --hidden ../inputs/evil.dat\",\n"
+      "      \"mean\": 1.000123456,\n"
+      "      \"stddev\": null,\n"
+      "      \"median\": 1.000123456,\n"
+      "      \"user\": 0.000120000,\n"
+      "      \"system\": 0.000000000,\n"
+      "      \"min\": 1.000123456,\n"
+      "      \"max\": 1.000123456,\n"
+      "      \"times\": [1.000123456],\n"
+      "      \"exit_codes\": [0],\n"
+      "      \"parameters\": "
+      "{\"alg\": \"hidden\", \"puzzle\": \"evil\"},\n"
+      "      \"input\": \"../inputs/evil.dat\",\n"
+      "      \"time_ns\": 1000123456,\n"
+      "      \"solved\": true,\n"
+      "      \"assignments\": 74,\n"
+      "      \"solution\": \"1234\",\n"
+      "      \"stats\": null\n"
+      "    }\n"
+      "  ]\n"
+      "}\n"});
+
+  // anything JSON cannot hold as it is gets escaped
+  record.input_path = "a \"b\"\\\n";
+  record.solved = false;
+  record.stats.emplace();
+
+  std::ostringstream escaped;
+  write_json(escaped, record);
+  const std::string text {escaped.str()};
+  results.enforce_true(
+    text.find(R"("input": "a \"b\"\\\u000a")") != std::string::npos);
+  results.enforce_true(text.find(R"("solution": null)")
+                       != std::string::npos);
+  results.enforce_true(text.find(R"("stats": {"nodes": 0, )")
+                       != std::string::npos);
+
+  return results;
+}
+
+static auto test_csv() -> supl::test_results
+{
+  supl::test_results results;
+
+  run_record record {sample_record()};
+
+  std::ostringstream header;
+  write_csv_header(header);
+  // the columns of written_portion/data.csv come first
+  results.enforce_equal(
+    header.str().substr(0, 78),
+    std::string {"command,mean,stddev,median,user,system,min,max,"
+                 "parameter_alg,parameter_puzzle,"});
+
+  std::ostringstream row;
+  write_csv(row, record);
+  results.enforce_equal(
+    row.str(),
+    std::string {"./sudoku_solver --hidden ../inputs/evil.dat,"
+                 "1.000123456,,1.000123456,0.000120000,0.000000000,"
+                 "1.000123456,1.000123456,hidden,evil,"
+                 "../inputs/evil.dat,1000123456,true,74,1234"
+                 ",,,,,,,,,\n"});
+
+  // as many fields in every row as in the header
+  record.command = "say \"a, b\"";
+  record.stats.emplace();
+  record.stats->nodes = 4;
+  record.stats->branch_time = std::chrono::nanoseconds {7};
+
+  std::ostringstream quoted;
+  write_csv(quoted, record);
+  results.enforce_equal(
+    quoted.str(),
+    std::string {"\"say \"\"a, b\"\"\","
+                 "1.000123456,,1.000123456,0.000120000,0.000000000,"
+                 "1.000123456,1.000123456,hidden,evil,"
+                 "../inputs/evil.dat,1000123456,true,74,1234,"
+                 "4,0,0,0,0,0,0,0,7\n"});
+
+  // phases left untimed are left empty, rather than written as 0
+  record.stats->time_phases = false;
+
+  std::ostringstream untimed;
+  write_csv(untimed, record);
+  results.enforce_true(untimed.str().ends_with(",4,0,0,0,0,0,,,\n"));
+
+  return results;
+}
+
+static auto run_record_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("puzzle name", &test_puzzle_name);
+  section.add_test("json", &test_json);
+  section.add_test("csv", &test_csv);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(run_record_tests());
+
+  return runner.run();
+}
@@ -0,0 +1,310 @@
+// Every puzzle in inputs/ solved with every strategy,
+// its search effort held to the baselines in search_effort_baselines.txt
+//
+// Node and forced move counts, unlike times, are the same on every
+// machine and every run, so any rise above the baseline is a regression
+// in a heuristic rather than noise. Falling below it passes,
+// but is reported, so the baseline can be lowered to lock the gain in.
+//
+// Every search measured runs to the end, so that a regression anywhere
+// shows in its counts. --simple and --mrv cannot finish 25x25.dat
+// in any reasonable time, so those two are left out, in unfinishable.
+// branch_budget only guards against a regression that would never
+// finish either. It sits well above the longest search measured,
+// --simple on 16x16.dat at 722290 branches. A search which hits it
+// is "interrupted", which fails against a "solved" baseline,
+// while one which finishes where its baseline was cut off passes.
+//
+// Run with --write-baselines FILE to record the current counts
+// after a deliberate change.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "board_parser.hpp"
+#include "exact_cover.hpp"
+#include "search_stats.hpp"
+#include "solver_state.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+constexpr static std::size_t branch_budget {1'000'000};
+
+// input, relative to inputs/, and strategy flag
+using search_key = std::pair<std::string_view, std::string_view>;
+
+// the searches too long to measure
+constexpr static std::array<search_key, 2> unfinishable {{
+  {"more_examples/25x25.dat", "--mrv"},
+  {"more_examples/25x25.dat", "--simple"},
+}};
+
+struct effort {
+  std::string outcome {};
+  std::size_t nodes {};
+  std::size_t forced_moves {};
+};
+
+// keyed by input, relative to inputs/, and strategy flag
+using effort_table =
+  std::map<std::pair<std::string, std::string>, effort>;
+
+static auto outcome_name(const search_outcome outcome) -> std::string
+{
+  switch ( outcome ) {
+    case search_outcome::solved:
+      return "solved";
+    case search_outcome::exhausted:
+      return "exhausted";
+    case search_outcome::interrupted:
+      return "interrupted";
+  }
+
+  return "unknown";
+}
+
+template <unsigned BoxSize>
+static void measure_file(const std::string& contents,
+                         const std::string& input,
+                         effort_table& efforts)
+{
+  const auto [board, error] {parse_board<BoxSize>(contents)};
+
+  for ( const auto& strategy : basic_search_strategies<BoxSize> ) {
+    if ( strategy.use_exact_cover && BoxSize != 3 ) {
+      continue;
+    }
+
+    if ( std::ranges::find(unfinishable, search_key {input, strategy.flag})
+         != unfinishable.end() ) {
+      continue;
+    }
+
+    effort& measured {efforts[{input, std::string {strategy.flag}}]};
+
+    if ( ! board.has_value() ) {
+      measured.outcome = "malformed";
+      continue;
+    }
+
+    if ( ! board->is_valid() ) {
+      measured.outcome = "invalid";
+      continue;
+    }
+
+    search_stats stats {};
+
+    if constexpr ( BoxSize == 3 ) {
+      if ( strategy.use_exact_cover ) {
+        Sudoku solved {*board};
+        exact_cover_solver solver {};
+        measured.outcome = solver.solve(solved, &stats).second
+                           ? "solved"
+                           : "exhausted";
+        measured.nodes = stats.nodes;
+        continue;
+      }
+    }
+
+    basic_solver_state<BoxSize> state {*board};
+    basic_search<BoxSize> search {state,
+                                  strategy.optimization_callback,
+                                  strategy.selection_callback,
+                                  {.max_branch_count = branch_budget},
+                                  &stats};
+    std::size_t assignment_count {};
+
+    measured.outcome = outcome_name(search.next(assignment_count));
+    measured.nodes = stats.nodes;
+    measured.forced_moves = stats.forced_moves();
+  }
+}
+
+static auto measure_inputs() -> effort_table
+{
+  const std::filesystem::path directory {SUDOKU_INPUTS_DIR};
+  effort_table efforts {};
+
+  for ( const auto& entry :
+        std::filesystem::recursive_directory_iterator {directory} ) {
+    if ( ! entry.is_regular_file()
+         || entry.path().extension() != ".dat" ) {
+      continue;
+    }
+
+    std::ifstream infile {entry.path()};
+    std::ostringstream buffer;
+    buffer << infile.rdbuf();
+    const std::string contents {std::move(buffer).str()};
+
+    const std::string input {
+      std::filesystem::relative(entry.path(), directory)
+        .generic_string()};
+
+    switch ( count_cell_symbols(contents) ) {
+      case board_shape<2>::cell_count:
+        measure_file<2>(contents, input, efforts);
+        break;
+      case board_shape<4>::cell_count:
+        measure_file<4>(contents, input, efforts);
+        break;
+      case board_shape<5>::cell_count:
+        measure_file<5>(contents, input, efforts);
+        break;
+      default:
+        measure_file<3>(contents, input, efforts);
+        break;
+    }
+  }
+
+  return efforts;
+}
+
+// one line per input and strategy:
+// input, strategy, outcome, nodes, forced moves
+// blank lines and lines starting with # are skipped
+static auto read_baselines(std::istream& in) -> effort_table
+{
+  effort_table baselines {};
+
+  for ( std::string line; std::getline(in, line); ) {
+    if ( line.empty() || line.front() == '#' ) {
+      continue;
+    }
+
+    std::istringstream fields {line};
+    std::string input {};
+    std::string strategy {};
+    effort baseline {};
+    fields >> input >> strategy >> baseline.outcome >> baseline.nodes
+      >> baseline.forced_moves;
+
+    if ( fields ) {
+      baselines[{input, strategy}] = baseline;
+    }
+  }
+
+  return baselines;
+}
+
+static void write_baselines(std::ostream& out,
+                            const effort_table& efforts)
+{
+  out << "# Search effort baselines, checked by the search_effort test\n"
+      << "# Regenerate with: search_effort --write-baselines FILE\n"
+      << "# input strategy outcome nodes forced_moves\n";
+
+  for ( const auto& [key, measured] : efforts ) {
+    out << key.first << ' ' << key.second << ' ' << measured.outcome
+        << ' ' << measured.nodes << ' ' << measured.forced_moves << '\n';
+  }
+}
+
+static auto test_within_baselines() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::ifstream baseline_file {SEARCH_EFFORT_BASELINES};
+  results.enforce_true(baseline_file.is_open(),
+                       "reading " SEARCH_EFFORT_BASELINES);
+
+  const effort_table baselines {read_baselines(baseline_file)};
+  const effort_table efforts {measure_inputs()};
+
+  results.enforce_true(! efforts.empty(), "no inputs found");
+
+  for ( const auto& [key, measured] : efforts ) {
+    const std::string name {key.first + ' ' + key.second};
+    const auto found {baselines.find(key)};
+
+    results.enforce_true(found != baselines.end(),
+                         "no baseline for " + name);
+
+    if ( found == baselines.end() ) {
+      continue;
+    }
+
+    const effort& baseline {found->second};
+
+    // finishing a search the budget used to cut off is an improvement,
+    // and its counts cannot be compared with where it was cut off
+    if ( baseline.outcome == "interrupted"
+         && measured.outcome == "solved" ) {
+      std::cerr << name << " now finishes, "
+                << "which --write-baselines would record\n";
+      continue;
+    }
+
+    results.enforce_equal(measured.outcome, baseline.outcome, name);
+    results.enforce_true(measured.nodes <= baseline.nodes,
+                         name + ": " + std::to_string(measured.nodes)
+                           + " nodes, baseline "
+                           + std::to_string(baseline.nodes));
+    results.enforce_true(measured.forced_moves <= baseline.forced_moves,
+                         name + ": "
+                           + std::to_string(measured.forced_moves)
+                           + " forced moves, baseline "
+                           + std::to_string(baseline.forced_moves));
+
+    if ( measured.nodes < baseline.nodes
+         || measured.forced_moves < baseline.forced_moves ) {
+      std::cerr << name << " is below its baseline, "
+                << "which --write-baselines would lower\n";
+    }
+  }
+
+  for ( const auto& [key, baseline] : baselines ) {
+    results.enforce_true(efforts.contains(key),
+                         "baseline for missing input " + key.first + ' '
+                           + key.second);
+  }
+
+  return results;
+}
+
+static auto search_effort_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("search effort within baselines",
+                   &test_within_baselines);
+
+  return section;
+}
+
+auto main(const int argc, const char* const* const argv) -> int
+{
+  using namespace std::literals;  // for operator""sv string_view literal
+
+  if ( argc == 3 && "--write-baselines"sv == argv[1] ) {
+    std::ofstream out {argv[2]};
+
+    if ( ! out.is_open() ) {
+      std::cerr << "Error opening file: \"" << argv[2] << "\"\n";
+      return EXIT_FAILURE;
+    }
+
+    write_baselines(out, measure_inputs());
+    return EXIT_SUCCESS;
+  }
+
+  supl::test_runner runner;
+
+  runner.add_section(search_effort_tests());
+
+  return runner.run();
+}
@@ -0,0 +1,297 @@
+#include <chrono>
+#include <cstddef>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "search_stats.hpp"
+#include "strategy.hpp"
+#include "sudoku.hpp"
+
+using namespace supl::literals::size_t_literal;
+
+constexpr static std::string_view evil_line {
+  "_6_8_______4_6___91___43_6__52________86_93________57__1_48___5"
+  "8___1_2_______5_4_"};
+
+// two 6s in the first row
+constexpr static std::string_view invalid_line {
+  "66_8_______4_6___91___43_6__52________86_93________57__1_48___5"
+  "8___1_2_______5_4_"};
+
+static auto level_sums(const search_stats& stats) -> search_stats::level
+{
+  return std::accumulate(
+    stats.levels.begin(),
+    stats.levels.end(),
+    search_stats::level {},
+    [](const search_stats::level sum, const search_stats::level& level) {
+      return search_stats::level {sum.nodes + level.nodes,
+                                  sum.branches + level.branches};
+    });
+}
+
+static auto test_counts_agree() -> supl::test_results
+{
+  supl::test_results results;
+
+  if constexpr ( ! search_stats::enabled ) {
+    return results;
+  }
+
+  for ( const search_strategy& strategy : search_strategies ) {
+    const std::string flag {strategy.flag};
+    solver_context context {};
+
+    Sudoku counted {*Sudoku::from_line(evil_line)};
+    search_stats stats {};
+    const auto [assignment_count, solved] {
+      context.solve(counted, strategy, &stats)};
+
+    // counting changes nothing about the search
+    Sudoku uncounted {*Sudoku::from_line(evil_line)};
+    results.enforce_equal(context.solve(uncounted, strategy).first,
+                          assignment_count,
+                          flag);
+    results.enforce_true(solved, flag);
+    results.enforce_true(counted == uncounted, flag);
+
+    // every assignment is either forced or a branch
+    results.enforce_equal(stats.forced_moves() + stats.branches,
+                          assignment_count,
+                          flag);
+    // and every branch leads to a node below the root
+    results.enforce_equal(stats.nodes, stats.branches + 1, flag);
+    results.enforce_true(stats.backtracks < stats.nodes, flag);
+
+    const search_stats::level sums {level_sums(stats)};
+    results.enforce_equal(sums.nodes, stats.nodes, flag);
+    results.enforce_equal(sums.branches, stats.branches, flag);
+    results.enforce_equal(stats.levels.at(0).nodes, 1_z, flag);
+    results.enforce_true(stats.levels.at(stats.max_depth).nodes > 0,
+                         flag);
+    results.enforce_equal(stats.levels.at(stats.max_depth + 1).nodes,
+                          0_z,
+                          flag);
+  }
+
+  return results;
+}
+
+static auto test_forced_moves() -> supl::test_results
+{
+  supl::test_results results;
+
+  if constexpr ( ! search_stats::enabled ) {
+    return results;
+  }
+
+  const auto stats_of {[](const std::string_view flag) {
+    search_stats stats {};
+    const search_strategy* const strategy {find_strategy(flag)};
+
+    if ( strategy != nullptr ) {
+      Sudoku board {*Sudoku::from_line(evil_line)};
+      solver_context context {};
+      static_cast<void>(context.solve(board, *strategy, &stats));
+    }
+
+    return stats;
+  }};
+
+  const search_stats simple {stats_of("--simple")};
+  results.enforce_equal(simple.forced_moves(), 0_z, "simple");
+
+  const search_stats smart {stats_of("--smart")};
+  results.enforce_true(smart.naked_singles > 0, "smart");
+  results.enforce_equal(smart.hidden_singles, 0_z, "smart");
+
+  const search_stats hidden {stats_of("--hidden")};
+  results.enforce_true(hidden.naked_singles > 0, "hidden");
+  results.enforce_true(hidden.hidden_singles > 0, "hidden");
+
+  // the exact cover engine forces nothing by name
+  const search_stats dlx {stats_of("--dlx")};
+  results.enforce_equal(dlx.forced_moves(), 0_z, "dlx");
+  results.enforce_true(dlx.branches > 0, "dlx");
+
+  // forcing moves is what keeps the search shallow and narrow
+  results.enforce_true(hidden.nodes < smart.nodes);
+  results.enforce_true(smart.nodes < simple.nodes);
+  results.enforce_true(hidden.max_depth < simple.max_depth);
+
+  return results;
+}
+
+static auto test_accumulates() -> supl::test_results
+{
+  supl::test_results results;
+
+  if constexpr ( ! search_stats::enabled ) {
+    return results;
+  }
+
+  const search_strategy& strategy {*find_strategy("--mrv")};
+  solver_context context {};
+  search_stats stats {};
+
+  Sudoku first {*Sudoku::from_line(evil_line)};
+  static_cast<void>(context.solve(first, strategy, &stats));
+  const search_stats once {stats};
+
+  Sudoku second {*Sudoku::from_line(evil_line)};
+  static_cast<void>(context.solve(second, strategy, &stats));
+
+  results.enforce_equal(stats.nodes, 2 * once.nodes);
+  results.enforce_equal(stats.branches, 2 * once.branches);
+  results.enforce_equal(stats.naked_singles, 2 * once.naked_singles);
+  results.enforce_equal(stats.max_depth, once.max_depth);
+  results.enforce_true(stats.propagate_time >= once.propagate_time);
+
+  // an invalid board is turned away before any search
+  Sudoku invalid {*Sudoku::from_line(invalid_line)};
+  search_stats rejected {};
+  results.enforce_false(
+    context.solve(invalid, strategy, &rejected).second);
+  results.enforce_equal(rejected.nodes, 0_z);
+
+  return results;
+}
+
+static auto test_untimed() -> supl::test_results
+{
+  supl::test_results results;
+
+  if constexpr ( ! search_stats::enabled ) {
+    return results;
+  }
+
+  const search_strategy& strategy {*find_strategy("--hidden")};
+  solver_context context {};
+
+  Sudoku timed_board {*Sudoku::from_line(evil_line)};
+  search_stats timed {};
+  static_cast<void>(context.solve(timed_board, strategy, &timed));
+
+  Sudoku untimed_board {*Sudoku::from_line(evil_line)};
+  search_stats untimed {};
+  untimed.time_phases = false;
+  static_cast<void>(context.solve(untimed_board, strategy, &untimed));
+
+  // the same counts, without the clock
+  results.enforce_equal(untimed.nodes, timed.nodes);
+  results.enforce_equal(untimed.branches, timed.branches);
+  results.enforce_equal(untimed.forced_moves(), timed.forced_moves());
+  results.enforce_true(untimed.validate_time == search_stats::duration {});
+  results.enforce_true(untimed.propagate_time
+                       == search_stats::duration {});
+  results.enforce_true(untimed.branch_time == search_stats::duration {});
+
+  return results;
+}
+
+static auto test_compiled_out() -> supl::test_results
+{
+  supl::test_results results;
+
+  if constexpr ( search_stats::enabled ) {
+    return results;
+  }
+
+  Sudoku board {*Sudoku::from_line(evil_line)};
+  search_stats stats {};
+  results.enforce_true(board
+                         .solve(&hidden_single_optimization,
+                                &minimum_remaining_values_selection,
+                                &stats)
+                         .second);
+
+  results.enforce_equal(stats.nodes, 0_z);
+  results.enforce_equal(stats.forced_moves(), 0_z);
+  results.enforce_true(stats.validate_time == search_stats::duration {});
+
+  return results;
+}
+
+static auto test_output() -> supl::test_results
+{
+  supl::test_results results;
+
+  search_stats stats {};
+  stats.nodes = 4;
+  stats.branches = 3;
+  stats.backtracks = 1;
+  stats.naked_singles = 56;
+  stats.hidden_singles = 15;
+  stats.max_depth = 1;
+  stats.levels.at(0) = {1, 2};
+  stats.levels.at(1) = {3, 1};
+  stats.propagate_time = std::chrono::nanoseconds {1500};
+
+  std::ostringstream json;
+  write_json(json, stats);
+  results.enforce_equal(
+    json.str(),
+    std::string {
+      R"({"nodes": 4, "branches": 3, "backtracks": 1, )"
+      R"("forced_moves": {"naked_singles": 56, "hidden_singles": 15}, )"
+      R"("max_depth": 1, )"
+      R"("time_ns": {"validate": 0, "propagate": 1500, "branch": 0}, )"
+      R"("levels": [{"nodes": 1, "branches": 2}, )"
+      R"({"nodes": 3, "branches": 1}]})"});
+
+  std::ostringstream text;
+  text << stats;
+  results.enforce_equal(
+    text.str(),
+    std::string {"Nodes: 4\n"
+                 "Branches: 3\n"
+                 "Backtracks: 1\n"
+                 "Forced moves: 71 (naked singles: 56, "
+                 "hidden singles: 15)\n"
+                 "Maximum depth: 1\n"
+                 "Validate: 0ns\n"
+                 "Propagate: 1500ns\n"
+                 "Branch: 0ns\n"
+                 "Depth\tNodes\tBranches\n"
+                 "0\t1\t2\n"
+                 "1\t3\t1\n"});
+
+  stats.time_phases = false;
+  std::ostringstream untimed;
+  write_json(untimed, stats);
+  results.enforce_true(untimed.str().find(R"("time_ns": null, )")
+                       != std::string::npos);
+
+  return results;
+}
+
+static auto search_stats_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("counts agree with each other", &test_counts_agree);
+  section.add_test("forced moves by rule", &test_forced_moves);
+  section.add_test("stats accumulate", &test_accumulates);
+  section.add_test("phases untimed", &test_untimed);
+  section.add_test("compiled out", &test_compiled_out);
+  section.add_test("output", &test_output);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(search_stats_tests());
+
+  return runner.run();
+}
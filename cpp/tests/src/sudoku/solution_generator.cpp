@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cstddef>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "line_writer.hpp"
+#include "solution_generator.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+static auto get_hard() -> const Sudoku&
+{
+  static const Sudoku hard {
+    {
+     // clang-format off
+'7', '_', '_', '_', '_', '_', '_', '_', '_',
+'6', '_', '_', '4', '1', '_', '2', '5', '_',
+'_', '1', '3', '_', '9', '5', '_', '_', '_',
+'8', '6', '_', '_', '_', '_', '_', '_', '_',
+'3', '_', '1', '_', '_', '_', '4', '_', '5',
+'_', '_', '_', '_', '_', '_', '_', '8', '6',
+'_', '_', '_', '8', '4', '_', '5', '3', '_',
+'_', '4', '2', '_', '3', '6', '_', '_', '7',
+'_', '_', '_', '_', '_', '_', '_', '_', '9',
+     // clang-format on
+    }
+  };
+
+  return hard;
+}
+
+static auto get_empty_4x4() -> const basic_sudoku<2>&
+{
+  static const auto empty {
+    basic_sudoku<2>::from_line("................").value()};
+
+  return empty;
+}
+
+static auto test_unique_solution() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  Sudoku expected {get_hard()};
+  const auto [assignment_count, solved] {expected.solve(
+    &hidden_single_optimization, &minimum_remaining_values_selection)};
+  results.enforce_true(solved);
+
+  solution_generator solutions {get_hard(),
+                                &hidden_single_optimization,
+                                &minimum_remaining_values_selection};
+
+  const Sudoku* const first {solutions.next()};
+  results.enforce_true(first != nullptr);
+  if ( first != nullptr ) {
+    results.enforce_equal(*first, expected);
+  }
+
+  // the first solution is found exactly as solve finds it
+  results.enforce_equal(solutions.assignment_count(), assignment_count);
+
+  results.enforce_true(solutions.next() == nullptr);
+  results.enforce_true(solutions.next() == nullptr, "stays exhausted");
+  results.enforce_equal(solutions.solution_count(), 1_z);
+
+  return results;
+}
+
+static auto test_every_solution() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  basic_solution_generator<2> solutions {
+    get_empty_4x4(),
+    &trivial_move_optimization,
+    &minimum_remaining_values_selection};
+
+  std::set<basic_sudoku<2>> seen;
+  for ( const auto& solution : solutions ) {
+    results.enforce_true(solution.is_solved());
+    seen.insert(solution);
+  }
+
+  // there are 288 distinct 4x4 boards
+  results.enforce_equal(seen.size(), 288_z);
+  results.enforce_equal(solutions.solution_count(), 288_z);
+
+  return results;
+}
+
+static auto test_resume() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  basic_solution_generator<2> all {
+    get_empty_4x4(), &null_optimization, &first_unassigned_selection};
+  basic_solution_generator<2> in_parts {
+    get_empty_4x4(), &null_optimization, &first_unassigned_selection};
+
+  auto whole {all.begin()};
+
+  // stop early, then pick up where the first loop left off
+  for ( const auto& solution : in_parts ) {
+    results.enforce_equal(solution, *whole);
+    ++whole;
+
+    if ( in_parts.solution_count() == 10 ) {
+      break;
+    }
+  }
+
+  for ( const auto& solution : in_parts ) {
+    results.enforce_equal(solution, *whole);
+    ++whole;
+  }
+
+  results.enforce_true(whole == all.end());
+  results.enforce_equal(in_parts.solution_count(), 288_z);
+
+  return results;
+}
+
+static auto test_no_solution() -> supl::test_results
+{
+  supl::test_results results;
+
+  // two 7s in the first row
+  Sudoku invalid {get_hard()};
+  invalid.set_cell({0, 1}, '7');
+
+  solution_generator from_invalid {
+    invalid, &trivial_move_optimization, &first_unassigned_selection};
+  results.enforce_true(from_invalid.begin() == from_invalid.end());
+
+  // the top left cell can only be 6, which its column already holds
+  Sudoku stuck {get_hard()};
+  const std::string_view first_row {"_25378194"};
+  for ( unsigned col {0}; col < 9; ++col ) {
+    stuck.set_cell({0, col}, first_row.at(col));
+  }
+  results.enforce_true(stuck.is_valid());
+
+  solution_generator from_stuck {
+    stuck, &trivial_move_optimization, &first_unassigned_selection};
+  results.enforce_true(from_stuck.next() == nullptr);
+
+  return results;
+}
+
+static auto test_line_writer() -> supl::test_results
+{
+  supl::test_results results;
+
+  std::ostringstream out;
+  std::string expected;
+
+  {
+    // small enough to be flushed several times over
+    line_writer writer {out, 8};
+
+    for ( const std::string line : {"abc", "defgh", "", "ij"} ) {
+      writer.write_line(line);
+      expected += line + '\n';
+    }
+
+    writer.write_line("longer than the buffer");
+    expected += "longer than the buffer\n";
+
+    writer.write_line("k");
+    expected += "k\n";
+  }
+
+  results.enforce_equal(out.str(), expected);
+
+  return results;
+}
+
+static auto solution_generator_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("unique solution", &test_unique_solution);
+  section.add_test("every solution", &test_every_solution);
+  section.add_test("resume after stopping early", &test_resume);
+  section.add_test("no solution", &test_no_solution);
+  section.add_test("line writer", &test_line_writer);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(solution_generator_tests());
+
+  return runner.run();
+}
@@ -0,0 +1,258 @@
+#include <array>
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+static auto get_hard() -> const Sudoku&
+{
+  static const Sudoku hard {
+    {
+     // clang-format off
+'7', '_', '_', '_', '_', '_', '_', '_', '_',
+'6', '_', '_', '4', '1', '_', '2', '5', '_',
+'_', '1', '3', '_', '9', '5', '_', '_', '_',
+'8', '6', '_', '_', '_', '_', '_', '_', '_',
+'3', '_', '1', '_', '_', '_', '4', '_', '5',
+'_', '_', '_', '_', '_', '_', '_', '8', '6',
+'_', '_', '_', '8', '4', '_', '5', '3', '_',
+'_', '4', '2', '_', '3', '6', '_', '_', '7',
+'_', '_', '_', '_', '_', '_', '_', '_', '9',
+     // clang-format on
+    }
+  };
+
+  return hard;
+}
+
+struct strategy {
+  std::add_pointer_t<std::size_t(solver_state&)> optimization;
+  std::add_pointer_t<index_pair(const solver_state&)> selection;
+};
+
+constexpr static std::array strategies {
+  strategy {&null_optimization, &first_unassigned_selection},
+  strategy {&trivial_move_optimization, &first_unassigned_selection},
+  strategy {&trivial_move_optimization,
+            &minimum_remaining_values_selection},
+  strategy {&hidden_single_optimization,
+            &minimum_remaining_values_selection},
+};
+
+static auto test_solve_each_strategy() -> supl::test_results
+{
+  supl::test_results results;
+
+  for ( const auto& [optimization, selection] : strategies ) {
+    Sudoku board {get_hard()};
+
+    const auto [assignment_count, solved] {
+      board.solve(optimization, selection)};
+
+    results.enforce_true(solved);
+    results.enforce_true(board.is_solved());
+    results.enforce_true(assignment_count > 0);
+
+    // clues are untouched
+    for ( const unsigned cell : std::views::iota(0U, 81U) ) {
+      const char clue {get_hard().data().at(cell)};
+      if ( clue != '_' ) {
+        results.enforce_equal(board.data().at(cell), clue);
+      }
+    }
+  }
+
+  return results;
+}
+
+static auto test_solve_impossible() -> supl::test_results
+{
+  supl::test_results results;
+
+  const Sudoku impossible {
+    {
+     // clang-format off
+'7', '3', '2', '1', '8', '_', '4', '9', '6',
+'5', '6', '_', '2', '9', '4', '7', '1', '3',
+'8', '1', '4', '3', '6', '_', '5', '2', '_',
+'3', '7', '5', '9', '1', '2', '8', '_', '4',
+'4', '2', '6', '8', '7', '5', '1', '3', '9',
+'1', '9', '8', '4', '3', '_', '6', '5', '7',
+'6', '5', '3', '_', '2', '7', '9', '4', '1',
+'9', '4', '1', '6', '5', '3', '_', '7', '2',
+'2', '8', '_', '_', '4', '_', '3', '6', '5',
+     // clang-format on
+    }
+  };
+
+  for ( const auto& [optimization, selection] : strategies ) {
+    Sudoku board {impossible};
+
+    results.enforce_false(board.solve(optimization, selection).second);
+    results.enforce_equal(board, impossible);
+
+    results.enforce_equal(
+      impossible.count_solutions(optimization, selection, 2).second,
+      std::size_t {0});
+  }
+
+  return results;
+}
+
+static auto test_count_solutions() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  const Sudoku empty {std::array<char, 81> {[]() {
+    std::array<char, 81> cells {};
+    cells.fill('_');
+    return cells;
+  }()}};
+
+  // there are 288 distinct 4x4 boards
+  const auto empty_4x4 {
+    basic_sudoku<2>::from_line("................").value()};
+
+  for ( const auto& [optimization, selection] : strategies ) {
+    const auto [assignment_count, solution_count] {
+      get_hard().count_solutions(optimization, selection, 2)};
+
+    results.enforce_equal(solution_count, 1_z, "unique");
+    results.enforce_true(assignment_count > 0);
+
+    // no limit, nothing past the single solution
+    results.enforce_equal(
+      get_hard().count_solutions(optimization, selection, 0).second,
+      1_z,
+      "unique, no limit");
+
+    results.enforce_equal(
+      empty.count_solutions(optimization, selection, 2).second,
+      2_z,
+      "stop at limit");
+    results.enforce_equal(
+      empty.count_solutions(optimization, selection, 50).second,
+      50_z,
+      "stop at larger limit");
+  }
+
+  results.enforce_equal(
+    empty_4x4
+      .count_solutions(&null_optimization<2>,
+                       &first_unassigned_selection<2>,
+                       0)
+      .second,
+    288_z,
+    "every 4x4 board");
+  results.enforce_equal(
+    empty_4x4
+      .count_solutions(&hidden_single_optimization<2>,
+                       &minimum_remaining_values_selection<2>,
+                       0)
+      .second,
+    288_z,
+    "every 4x4 board with singles");
+
+  return results;
+}
+
+static auto test_count_solutions_rollback() -> supl::test_results
+{
+  using namespace supl::literals::size_t_literal;
+
+  supl::test_results results;
+
+  solver_state state {get_hard()};
+  std::size_t assignment_count {};
+
+  results.enforce_equal(count_solutions(state,
+                                        &hidden_single_optimization,
+                                        &minimum_remaining_values_selection,
+                                        assignment_count,
+                                        1),
+                        1_z);
+  results.enforce_equal(state.board(), get_hard(), "rolled back at limit");
+
+  results.enforce_equal(count_solutions(state,
+                                        &hidden_single_optimization,
+                                        &minimum_remaining_values_selection,
+                                        assignment_count,
+                                        0),
+                        1_z);
+  results.enforce_equal(
+    state.board(), get_hard(), "rolled back when exhausted");
+
+  return results;
+}
+
+static auto test_minimum_remaining_values() -> supl::test_results
+{
+  supl::test_results results;
+
+  // (0, 7) and (0, 8) are the only cells with two legal values,
+  // (0, 7) has one fewer unassigned peer due to (8, 7)
+  const solver_state state {Sudoku {
+    {
+     // clang-format off
+'1', '2', '3', '4', '5', '6', '7', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '3', '_',
+     // clang-format on
+    }
+  }};
+
+  results.enforce_equal(minimum_remaining_values_selection(state),
+                        index_pair {0, 8});
+  results.enforce_equal(first_unassigned_selection(state),
+                        index_pair {0, 7});
+
+  // a forced cell always comes first
+  const solver_state hard {get_hard()};
+  results.enforce_equal(minimum_remaining_values_selection(hard),
+                        index_pair {7, 7});
+  results.enforce_equal(first_unassigned_selection(hard),
+                        index_pair {0, 1});
+
+  return results;
+}
+
+static auto solve_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("solve with each strategy", &test_solve_each_strategy);
+  section.add_test("solve impossible board", &test_solve_impossible);
+  section.add_test("count solutions", &test_count_solutions);
+  section.add_test("count solutions rolls back",
+                   &test_count_solutions_rollback);
+  section.add_test("minimum remaining values selection",
+                   &test_minimum_remaining_values);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(solve_tests());
+
+  return runner.run();
+}
@@ -0,0 +1,222 @@
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+using namespace supl::literals::size_t_literal;
+
+static auto get_legal_partial() -> const Sudoku&
+{
+  static const Sudoku legal_partial {
+    {
+     // clang-format off
+'_', '9', '_', '_', '_', '6', '_', '4', '_',
+'_', '_', '5', '3', '_', '_', '_', '_', '8',
+'_', '_', '_', '_', '7', '_', '2', '_', '_',
+'_', '_', '1', '_', '5', '_', '_', '_', '3',
+'_', '6', '_', '_', '_', '9', '_', '7', '_',
+'2', '_', '_', '_', '8', '4', '1', '_', '_',
+'_', '_', '3', '_', '1', '_', '_', '_', '_',
+'8', '_', '_', '_', '_', '2', '5', '_', '_',
+'_', '5', '_', '4', '_', '_', '_', '8', '_',
+     // clang-format on
+    }
+  };
+
+  return legal_partial;
+}
+
+// every maintained domain must match one computed from scratch
+static void enforce_domains_match_board(const solver_state& state,
+                                        supl::test_results& results)
+{
+  for ( const unsigned row : std::views::iota(0U, 9U) ) {
+    for ( const unsigned col : std::views::iota(0U, 9U) ) {
+      results.enforce_equal(state.domain({row, col}),
+                            state.board().candidates({row, col}),
+                            supl::to_string(index_pair {row, col}));
+    }
+  }
+}
+
+static auto test_assign_updates_peers() -> supl::test_results
+{
+  supl::test_results results;
+
+  solver_state state {get_legal_partial()};
+  enforce_domains_match_board(state, results);
+
+  const std::vector<Assignment> assignments {
+    {{0, 0}, '1'},
+    {{0, 4}, '2'},
+    {{4, 3}, '1'},
+    {{8, 8}, '9'},
+  };
+
+  for ( const Assignment& assignment : assignments ) {
+    state.assign(assignment);
+    enforce_domains_match_board(state, results);
+  }
+
+  return results;
+}
+
+static auto test_undo_restores_state() -> supl::test_results
+{
+  supl::test_results results;
+
+  solver_state state {get_legal_partial()};
+
+  state.assign({{0, 0}, '1'});
+  const auto point {state.mark()};
+  const Sudoku board_at_point {state.board()};
+
+  state.assign({{0, 4}, '2'});
+  state.assign({{4, 3}, '1'});
+  state.undo(point);
+
+  results.enforce_equal(state.board(), board_at_point);
+  enforce_domains_match_board(state, results);
+
+  state.undo(0);
+
+  results.enforce_equal(state.board(), get_legal_partial());
+  enforce_domains_match_board(state, results);
+
+  return results;
+}
+
+static auto test_wipeout_detection() -> supl::test_results
+{
+  supl::test_results results;
+
+  // (0, 8) may only be '9'
+  Sudoku board {
+    {
+     // clang-format off
+'1', '2', '3', '4', '5', '6', '7', '8', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+     // clang-format on
+    }
+  };
+
+  solver_state state {board};
+  results.enforce_false(state.has_wipeout());
+
+  // strikes '9' from the only legal value of (0, 8)
+  const auto point {state.mark()};
+  state.assign({{5, 8}, '9'});
+  results.enforce_true(state.has_wipeout());
+
+  state.undo(point);
+  results.enforce_false(state.has_wipeout());
+
+  results.enforce_equal(state.apply_naked_singles(), 1_z);
+  results.enforce_equal(state.board().mdview()(0, 8), '9');
+
+  return results;
+}
+
+static auto test_hidden_singles() -> supl::test_results
+{
+  supl::test_results results;
+
+  // '1' is excluded from every cell of row 0 but (0, 8),
+  // which is otherwise unconstrained
+  const Sudoku board {
+    {
+     // clang-format off
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'1', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '1', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '1', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '1', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+'_', '_', '_', '_', '_', '_', '_', '_', '_',
+     // clang-format on
+    }
+  };
+
+  solver_state state {board};
+
+  results.enforce_equal(state.domain({0, 8}).count(), 9_z);
+  results.enforce_equal(state.apply_naked_singles(), 0_z);
+
+  results.enforce_true(state.apply_hidden_singles() > 0);
+  results.enforce_equal(state.board().mdview()(0, 8), '1');
+  results.enforce_false(state.has_wipeout());
+  enforce_domains_match_board(state, results);
+
+  return results;
+}
+
+static auto test_singles_fixpoint() -> supl::test_results
+{
+  supl::test_results results;
+
+  // the "hard" problem from the homework document
+  // falls to singles alone
+  solver_state state {Sudoku {
+    {
+     // clang-format off
+'7', '_', '_', '_', '_', '_', '_', '_', '_',
+'6', '_', '_', '4', '1', '_', '2', '5', '_',
+'_', '1', '3', '_', '9', '5', '_', '_', '_',
+'8', '6', '_', '_', '_', '_', '_', '_', '_',
+'3', '_', '1', '_', '_', '_', '4', '_', '5',
+'_', '_', '_', '_', '_', '_', '_', '8', '6',
+'_', '_', '_', '8', '4', '_', '5', '3', '_',
+'_', '4', '2', '_', '3', '6', '_', '_', '7',
+'_', '_', '_', '_', '_', '_', '_', '_', '9',
+     // clang-format on
+    }
+  }};
+
+  const auto assignment_count {state.apply_singles()};
+
+  results.enforce_true(state.is_solved());
+  results.enforce_true(state.board().is_solved());
+  results.enforce_equal(assignment_count, 53_z);
+
+  return results;
+}
+
+static auto solver_state_tests() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("assign updates peer domains",
+                   &test_assign_updates_peers);
+  section.add_test("undo restores state", &test_undo_restores_state);
+  section.add_test("wipeout detection", &test_wipeout_detection);
+  section.add_test("hidden singles", &test_hidden_singles);
+  section.add_test("singles fixpoint", &test_singles_fixpoint);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(solver_state_tests());
+
+  return runner.run();
+}
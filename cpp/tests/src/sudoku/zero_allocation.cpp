@@ -0,0 +1,169 @@
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+#include <supl/utility.hpp>
+
+#include <supl/test_results.hpp>
+#include <supl/test_runner.hpp>
+#include <supl/test_section.hpp>
+
+#include "exact_cover.hpp"
+#include "solver_state.hpp"
+#include "sudoku.hpp"
+
+using namespace supl::literals::size_t_literal;
+
+// every allocation made by the program goes through these replacements
+// NOLINTNEXTLINE(*non-const-global*)
+static std::size_t allocation_count {0};
+
+auto operator new(const std::size_t size) -> void*
+{
+  ++allocation_count;
+
+  // operator new must return a unique pointer, even for a size of 0
+  if ( void* const ptr {std::malloc(size == 0 ? 1 : size)};
+       ptr != nullptr ) {
+    return ptr;
+  }
+
+  throw std::bad_alloc {};
+}
+
+auto operator new[](const std::size_t size) -> void*
+{
+  return ::operator new(size);
+}
+
+void operator delete(void* const ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* const ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* const ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* const ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+static auto get_evil() -> const Sudoku&
+{
+  static const Sudoku evil {
+    {
+     // clang-format off
+'_', '6', '_', '8', '_', '_', '_', '_', '_',
+'_', '_', '4', '_', '6', '_', '_', '_', '9',
+'1', '_', '_', '_', '4', '3', '_', '6', '_',
+'_', '5', '2', '_', '_', '_', '_', '_', '_',
+'_', '_', '8', '6', '_', '9', '3', '_', '_',
+'_', '_', '_', '_', '_', '_', '5', '7', '_',
+'_', '1', '_', '4', '8', '_', '_', '_', '5',
+'8', '_', '_', '_', '1', '_', '2', '_', '_',
+'_', '_', '_', '_', '_', '5', '_', '4', '_',
+     // clang-format on
+    }
+  };
+
+  return evil;
+}
+
+static auto test_solve_does_not_allocate() -> supl::test_results
+{
+  supl::test_results results;
+
+  struct strategy {
+    std::add_pointer_t<std::size_t(solver_state&)> optimization;
+    std::add_pointer_t<index_pair(const solver_state&)> selection;
+  };
+
+  constexpr static std::array strategies {
+    strategy {&null_optimization, &first_unassigned_selection},
+    strategy {&trivial_move_optimization, &first_unassigned_selection},
+    strategy {&trivial_move_optimization,
+              &minimum_remaining_values_selection},
+    strategy {&hidden_single_optimization,
+              &minimum_remaining_values_selection},
+  };
+
+  for ( const auto& [optimization, selection] : strategies ) {
+    Sudoku board {get_evil()};
+
+    const std::size_t allocations_before {allocation_count};
+    const bool solved {board.solve(optimization, selection).second};
+    const std::size_t allocations_after {allocation_count};
+
+    results.enforce_true(solved);
+    results.enforce_equal(allocations_after - allocations_before, 0_z);
+  }
+
+  return results;
+}
+
+static auto test_exact_cover_does_not_allocate() -> supl::test_results
+{
+  supl::test_results results;
+
+  exact_cover_solver solver {};
+  Sudoku board {get_evil()};
+
+  const std::size_t allocations_before {allocation_count};
+  const bool solved {solver.solve(board).second};
+  const std::size_t allocations_after {allocation_count};
+
+  results.enforce_true(solved);
+  results.enforce_equal(allocations_after - allocations_before, 0_z);
+
+  return results;
+}
+
+static auto test_formatting_does_not_allocate() -> supl::test_results
+{
+  supl::test_results results;
+
+  const Sudoku& board {get_evil()};
+  std::array<char, Sudoku::grid_size> text {};
+
+  const std::size_t allocations_before {allocation_count};
+  board.format_grid(text.data());
+  board.format_line(text.data());
+  const std::size_t allocations_after {allocation_count};
+
+  results.enforce_equal(allocations_after - allocations_before, 0_z);
+
+  return results;
+}
+
+static auto zero_allocation() -> supl::test_section
+{
+  supl::test_section section;
+
+  section.add_test("Sudoku::solve makes no allocations",
+                   &test_solve_does_not_allocate);
+  section.add_test("exact_cover_solver::solve makes no allocations",
+                   &test_exact_cover_does_not_allocate);
+  section.add_test("Sudoku::format_grid makes no allocations",
+                   &test_formatting_does_not_allocate);
+
+  return section;
+}
+
+auto main() -> int
+{
+  supl::test_runner runner;
+
+  runner.add_section(zero_allocation());
+
+  return runner.run();
+}